@@ -0,0 +1,41 @@
+#ifndef BENCH_BENCH_H_
+#define BENCH_BENCH_H_
+#include <stdint.h>	/* uint64_t */
+#include <time.h>	/* clock_gettime */
+
+/*			- bench.h -
+ * shared helpers for benchmark drivers (define _POSIX_C_SOURCE >= 199309L
+ * before including under -std=c99)
+ */
+
+static inline uint64_t bench_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (((uint64_t) now.tv_sec) * 1000000000lu)
+	     + ((uint64_t) now.tv_nsec);
+}
+
+static inline double bench_ns_per_op(const uint64_t start,
+				     const uint64_t stop,
+				     const uint64_t ops)
+{
+	return ((double) (stop - start)) / ((double) ops);
+}
+
+/* the 16-byte node most drivers queue: ordered by 'key', told apart by 'id' */
+struct Record {
+	uint64_t key;
+	uint64_t id;
+};
+
+/* min-heap order on 'key' */
+static inline int compare_record(const void *x,
+				 const void *y)
+{
+	return ((const struct Record *) x)->key
+	     < ((const struct Record *) y)->key;
+}
+#endif /* ifndef BENCH_BENCH_H_ */
@@ -0,0 +1,133 @@
+#include <chrono>	/* std::chrono::steady_clock */
+#include <cstdio>	/* std::printf */
+#include <cstdlib>	/* std::strtoul, std::exit */
+#include <vector>	/* std::vector */
+#include <utils/pcg_basic.h>
+#include <bheap/bheap.hpp>
+#include <bench/bheap_hpp_bench.h>
+
+/*			- bheap_hpp_bench.cpp -
+ * 'bheap::BHeap<T>' (inlined comparator, move semantics) vs 'struct BHeap'
+ * (function pointer comparator, 'memcpy' of runtime width) on 8- and 16-byte
+ * records
+ *
+ * usage: bheap_hpp_bench [length]
+ */
+
+namespace {
+
+struct Record8 {
+	uint64_t key;
+};
+
+struct Record16 {
+	uint64_t key;
+	uint64_t payload;
+};
+
+template <typename Record>
+struct CompareKey {
+	bool operator()(const Record &x, const Record &y) const
+	{
+		return x.key < y.key;
+	}
+};
+
+double ns_per_op(const std::chrono::steady_clock::time_point start,
+		 const std::size_t ops)
+{
+	const std::chrono::duration<double, std::nano> elapsed
+		= std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / ops;
+}
+
+template <typename Record>
+void hpp_bheap_bench(HppBenchResult &result,
+		     const std::vector<uint64_t> &keys)
+{
+	typedef std::chrono::steady_clock clock;
+
+	bheap::BHeap<Record, CompareKey<Record> > heap;
+	const std::size_t length = keys.size();
+	Record next = Record();
+	uint64_t checksum = 0;
+	clock::time_point start;
+
+	start = clock::now();
+	for (std::size_t i = 0; i < length; ++i) {
+		next.key = keys[i];
+		heap.insert(next);
+	}
+	result.insert_ns = ns_per_op(start, length);
+
+	start = clock::now();
+	for (std::size_t i = 0; i < length; ++i) {
+		next	  = heap.extract();
+		next.key += keys[i];
+		heap.insert(next);
+	}
+	result.churn_ns = ns_per_op(start, length);
+
+	start = clock::now();
+	for (std::size_t i = 0; i < length; ++i)
+		checksum += heap.extract().key;
+	result.extract_ns = ns_per_op(start, length);
+
+	result.checksum = checksum;
+}
+
+template <typename Record>
+void report(const std::vector<uint64_t> &keys)
+{
+	HppBenchResult c_result, hpp_result;
+
+	c_bheap_bench(&c_result, keys.data(), keys.size(), sizeof(Record));
+	hpp_bheap_bench<Record>(hpp_result, keys);
+
+	if (c_result.checksum != hpp_result.checksum) {
+		std::printf("FAILED: checksum mismatch (%llu != %llu)\n",
+			    (unsigned long long) c_result.checksum,
+			    (unsigned long long) hpp_result.checksum);
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::printf("%2zu-byte records, %zu nodes\n"
+		    "\t%-8s %12s %12s %8s\n"
+		    "\t%-8s %12.2f %12.2f %7.2fx\n"
+		    "\t%-8s %12.2f %12.2f %7.2fx\n"
+		    "\t%-8s %12.2f %12.2f %7.2fx\n",
+		    sizeof(Record), keys.size(),
+		    "ns/op", "struct", "template", "speedup",
+		    "insert",
+		    c_result.insert_ns, hpp_result.insert_ns,
+		    c_result.insert_ns / hpp_result.insert_ns,
+		    "churn",
+		    c_result.churn_ns, hpp_result.churn_ns,
+		    c_result.churn_ns / hpp_result.churn_ns,
+		    "extract",
+		    c_result.extract_ns, hpp_result.extract_ns,
+		    c_result.extract_ns / hpp_result.extract_ns);
+}
+
+} /* namespace */
+
+int main(int argc, char *argv[])
+{
+	const std::size_t length = (argc > 1)
+				 ? std::strtoul(argv[1], NULL, 10)
+				 : 1000000;
+	pcg32_random_t rng;
+	std::vector<uint64_t> keys(length);
+
+	pcg32_srandom_r(&rng, 42u, 54u);
+
+	for (std::size_t i = 0; i < length; ++i)
+		keys[i] = (((uint64_t) pcg32_random_r(&rng)) << 32)
+			| pcg32_random_r(&rng);
+
+	report<Record8>(keys);
+	report<Record16>(keys);
+
+	return 0;
+}
@@ -0,0 +1,32 @@
+#ifndef BENCH_BHEAP_HPP_BENCH_H_
+#define BENCH_BHEAP_HPP_BENCH_H_
+#include <stddef.h>	/* size_t */
+#include <stdint.h>	/* uint64_t */
+
+/*			- bheap_hpp_bench.h -
+ * C half of the 'bheap::BHeap' vs 'struct BHeap' benchmark, kept in its own
+ * translation unit so that bheap.h is only ever compiled as C
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct HppBenchResult {
+	double insert_ns;	/* ns per insert */
+	double extract_ns;	/* ns per extract */
+	double churn_ns;	/* ns per extract + insert at steady size */
+	uint64_t checksum;	/* sum of extracted keys, defeats elision */
+};
+
+/* 'length' inserts, 'length' churn rounds, 'length' extracts of 'width'-byte
+ * records keyed on their leading uint64_t */
+void c_bheap_bench(struct HppBenchResult *result,
+		   const uint64_t *keys,
+		   const size_t length,
+		   const size_t width);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ifndef BENCH_BHEAP_HPP_BENCH_H_ */
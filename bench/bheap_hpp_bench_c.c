@@ -0,0 +1,53 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+#include <bench/bheap_hpp_bench.h>
+
+static int compare_key(const void *x,
+		       const void *y)
+{
+	return *((const uint64_t *) x) < *((const uint64_t *) y);
+}
+
+void c_bheap_bench(struct HppBenchResult *result,
+		   const uint64_t *keys,
+		   const size_t length,
+		   const size_t width)
+{
+	struct BHeap *heap = init_bheap(width, &compare_key);
+	char next[width];
+	uint64_t checksum = 0lu;
+	uint64_t start;
+	uint64_t *root;
+	size_t i;
+
+	memset(&next[0l], 0, width);
+
+	start = bench_now_ns();
+	for (i = 0ul; i < length; ++i) {
+		memcpy(&next[0l], &keys[i], sizeof(uint64_t));
+		bheap_insert(heap, &next[0l]);
+	}
+	result->insert_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	start = bench_now_ns();
+	for (i = 0ul; i < length; ++i) {
+		root = bheap_extract(heap);
+		memcpy(&next[0l], root, width);
+		*((uint64_t *) &next[0l]) += keys[i];
+		bheap_insert(heap, &next[0l]);
+	}
+	result->churn_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	start = bench_now_ns();
+	for (i = 0ul; i < length; ++i) {
+		root = bheap_extract(heap);
+		checksum += *root;
+	}
+	result->extract_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	result->checksum = checksum;
+
+	free_bheap(heap);
+}
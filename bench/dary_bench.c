@@ -0,0 +1,102 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- dary_bench.c -
+ * extract-heavy workloads on 2/4/8/16-ary heaps of 8- and 16-byte nodes
+ *
+ * usage: dary_bench [length]
+ */
+
+static int compare_key(const void *x,
+		       const void *y)
+{
+	return *((const uint64_t *) x) < *((const uint64_t *) y);
+}
+
+static void dary_bench(const uint64_t *keys,
+		       const size_t length,
+		       const size_t width,
+		       const size_t arity)
+{
+	struct BHeap *heap = init_dary_bheap(width, arity, &compare_key);
+	char next[width];
+	uint64_t checksum = 0lu;
+	uint64_t start;
+	double insert_ns, churn_ns, extract_ns, sort_ns;
+	uint64_t *root;
+	size_t i;
+
+	memset(&next[0l], 0, width);
+
+	start = bench_now_ns();
+	for (i = 0ul; i < length; ++i) {
+		memcpy(&next[0l], &keys[i], sizeof(uint64_t));
+		bheap_insert(heap, &next[0l]);
+	}
+	insert_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	start = bench_now_ns();
+	for (i = 0ul; i < length; ++i) {
+		root = bheap_extract(heap);
+		memcpy(&next[0l], root, width);
+		*((uint64_t *) &next[0l]) += keys[i] >> 8;
+		bheap_insert(heap, &next[0l]);
+	}
+	churn_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	start = bench_now_ns();
+	for (i = 0ul; i < length; ++i) {
+		root = bheap_extract(heap);
+		checksum += *root;
+	}
+	extract_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	/* reuse node buffer for an in-place heapsort of the original keys */
+	for (i = 0ul; i < length; ++i)
+		memcpy(&heap->nodes[(i + 1ul) * width], &keys[i],
+		       sizeof(uint64_t));
+
+	start = bench_now_ns();
+	sort_dary_bheap_nodes(heap->nodes, length, width, arity,
+			      &compare_key);
+	sort_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	printf("%2zu\t%2zu\t%10zu\t%8.2f\t%8.2f\t%8.2f\t%8.2f\t%016lx\n",
+	       width, arity, length,
+	       insert_ns, churn_ns, extract_ns, sort_ns, checksum);
+
+	free_bheap(heap);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : (1ul << 21);
+	static const size_t widths[]  = { 8ul, 16ul };
+	static const size_t arities[] = { 2ul, 4ul, 8ul, 16ul };
+	uint64_t *keys;
+
+	HANDLE_MALLOC(keys, sizeof(uint64_t) * length);
+
+	seed_rng(42u);
+
+	for (size_t i = 0ul; i < length; ++i)
+		keys[i] = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+			| pcg32_random_r(&_RNG);
+
+	puts("width\tarity\tlength\t\tinsert\t\tchurn\t\textract\t\tsort"
+	     "\t\tchecksum\t(ns/op)");
+
+	for (size_t w = 0ul; w < sizeof(widths) / sizeof(widths[0]); ++w)
+		for (size_t a = 0ul; a < sizeof(arities) / sizeof(arities[0]);
+		     ++a)
+			dary_bench(keys, length, widths[w], arities[a]);
+
+	free(keys);
+
+	return 0;
+}
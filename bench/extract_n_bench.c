@@ -0,0 +1,156 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- extract_n_bench.c -
+ * draining batches of 'n' nodes: 'bheap_extract' loop (copying each root out)
+ * vs one 'bheap_extract_n', refilling the heap between batches.  Reports ns
+ * per node of the fastest batch (the sum is at the mercy of preemption) and
+ * comparisons per node over all batches.
+ *
+ * usage: extract_n_bench [length] [batches]
+ */
+
+static unsigned long comparisons;
+
+static int compare_counted(const void *x,
+			   const void *y)
+{
+	++comparisons;
+	return compare_record(x, y);
+}
+
+/* re-inserts 'batch' with fresh keys so both variants see the same heap */
+static void refill(struct BHeap *heap,
+		   struct Record *batch,
+		   const size_t n)
+{
+	for (size_t i = 0ul; i < n; ++i) {
+		batch[i].key += pcg32_random_r(&_RNG);
+		bheap_insert(heap, &batch[i]);
+	}
+}
+
+static double extract_loop(struct BHeap *heap,
+			   struct Record *batch,
+			   const size_t n,
+			   const size_t batches,
+			   uint64_t *checksum,
+			   double *cmp)
+{
+	uint64_t best = UINT64_MAX;
+	unsigned long count_cmp = 0ul;
+	uint64_t start, elapsed;
+
+	for (size_t b = 0ul; b < batches; ++b) {
+		comparisons = 0ul;
+		start = bench_now_ns();
+		for (size_t i = 0ul; i < n; ++i)
+			memcpy(&batch[i], bheap_extract(heap),
+			       sizeof(struct Record));
+		elapsed = bench_now_ns() - start;
+		count_cmp += comparisons;
+
+		if (elapsed < best)
+			best = elapsed;
+
+		*checksum += batch[n - 1ul].key;
+		refill(heap, batch, n);
+	}
+
+	*cmp = ((double) count_cmp) / (n * batches);
+
+	return ((double) best) / n;
+}
+
+static double extract_batch(struct BHeap *heap,
+			    struct Record *batch,
+			    const size_t n,
+			    const size_t batches,
+			    uint64_t *checksum,
+			    double *cmp)
+{
+	uint64_t best = UINT64_MAX;
+	unsigned long count_cmp = 0ul;
+	uint64_t start, elapsed;
+
+	for (size_t b = 0ul; b < batches; ++b) {
+		comparisons = 0ul;
+		start = bench_now_ns();
+		(void) bheap_extract_n(heap, batch, n);
+		elapsed = bench_now_ns() - start;
+		count_cmp += comparisons;
+
+		if (elapsed < best)
+			best = elapsed;
+
+		*checksum += batch[n - 1ul].key;
+		refill(heap, batch, n);
+	}
+
+	*cmp = ((double) count_cmp) / (n * batches);
+
+	return ((double) best) / n;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 1000000ul;
+	const size_t batches = (argc > 2)
+			     ? strtoul(argv[2], NULL, 10)
+			     : 200ul;
+	struct Record *records, *batch;
+	struct BHeap *heap;
+	uint64_t loop_checksum, batch_checksum;
+	double loop_ns, batch_ns, loop_cmp, batch_cmp;
+
+	HANDLE_MALLOC(records, sizeof(struct Record) * length);
+	HANDLE_MALLOC(batch,   sizeof(struct Record) * 4096ul);
+
+	puts("n\tlength\t\tloop ns\t\tbatch ns\tspeedup\tloop cmp"
+	     "\tbatch cmp\t(per node)");
+
+	for (size_t n = 16ul; n <= 4096ul; n *= 4ul) {
+		seed_rng(42u);
+		for (size_t i = 0ul; i < length; ++i) {
+			records[i].key = pcg32_random_r(&_RNG);
+			records[i].id  = i;
+		}
+		heap = array_into_bheap(records, length, sizeof(struct Record),
+					&compare_counted);
+		loop_checksum = 0lu;
+		loop_ns = extract_loop(heap, batch, n, batches,
+				       &loop_checksum, &loop_cmp);
+		free_bheap(heap);
+
+		seed_rng(42u);
+		for (size_t i = 0ul; i < length; ++i) {
+			records[i].key = pcg32_random_r(&_RNG);
+			records[i].id  = i;
+		}
+		heap = array_into_bheap(records, length, sizeof(struct Record),
+					&compare_counted);
+		batch_checksum = 0lu;
+		batch_ns = extract_batch(heap, batch, n, batches,
+					 &batch_checksum, &batch_cmp);
+		free_bheap(heap);
+
+		if (loop_checksum != batch_checksum) {
+			puts("FAILED: checksum mismatch");
+			return EXIT_FAILURE;
+		}
+
+		printf("%zu\t%10zu\t%8.2f\t%8.2f\t%7.2fx\t%8.2f\t%8.2f\n",
+		       n, length, loop_ns, batch_ns, loop_ns / batch_ns,
+		       loop_cmp, batch_cmp);
+	}
+
+	free(records);
+	free(batch);
+
+	return 0;
+}
@@ -0,0 +1,102 @@
+#ifndef BENCH_GRAPH_H_
+#define BENCH_GRAPH_H_
+#include <utils/utils.h>	/* HANDLE_MALLOC */
+#include <utils/rand.h>		/* rand_uint_upto */
+#include <bheap/bheap.h>	/* struct BHeap */
+
+/*			- graph.h -
+ * random sparse graph and the lazy-duplicate Dijkstra baseline shared by the
+ * shortest-path benchmark drivers
+ */
+
+#define INFINITE_DISTANCE UINT64_MAX
+
+struct Graph {
+	size_t count_vertices;
+	size_t *offsets;	/* edges of 'v' are [offsets[v], offsets[v + 1]) */
+	uint32_t *targets;
+	uint32_t *weights;
+};
+
+struct Entry {
+	uint64_t distance;
+	uint64_t vertex;
+};
+
+static inline int compare_entry(const void *x,
+				const void *y)
+{
+	return ((const struct Entry *) x)->distance
+	     < ((const struct Entry *) y)->distance;
+}
+
+static inline void init_graph(struct Graph *graph,
+			      const size_t count_vertices,
+			      const size_t degree)
+{
+	const size_t count_edges = count_vertices * degree;
+
+	graph->count_vertices = count_vertices;
+
+	HANDLE_MALLOC(graph->offsets, sizeof(size_t) * (count_vertices + 1ul));
+	HANDLE_MALLOC(graph->targets, sizeof(uint32_t) * count_edges);
+	HANDLE_MALLOC(graph->weights, sizeof(uint32_t) * count_edges);
+
+	for (size_t v = 0ul; v <= count_vertices; ++v)
+		graph->offsets[v] = v * degree;
+
+	for (size_t e = 0ul; e < count_edges; ++e) {
+		graph->targets[e] = rand_uint_upto(count_vertices - 1ul);
+		graph->weights[e] = rand_uint_upto(1000000u) + 1u;
+	}
+}
+
+static inline void free_graph(struct Graph *graph)
+{
+	free(graph->offsets);
+	free(graph->targets);
+	free(graph->weights);
+}
+
+static inline size_t lazy_dijkstra(const struct Graph *graph,
+				   uint64_t *distances)
+{
+	struct BHeap *heap = init_bheap(sizeof(struct Entry), &compare_entry);
+	struct Entry next = { 0lu, 0lu };
+	const struct Entry *root;
+	size_t peak = 0ul;
+
+	for (size_t v = 0ul; v < graph->count_vertices; ++v)
+		distances[v] = INFINITE_DISTANCE;
+
+	distances[0l] = 0lu;
+	bheap_insert(heap, &next);
+
+	while ((root = bheap_extract(heap)) != NULL) {
+		const uint64_t vertex	= root->vertex;
+		const uint64_t distance = root->distance;
+
+		/* stale duplicate */
+		if (distance > distances[vertex])
+			continue;
+
+		for (size_t e = graph->offsets[vertex];
+		     e < graph->offsets[vertex + 1ul]; ++e) {
+			next.distance = distance + graph->weights[e];
+			next.vertex   = graph->targets[e];
+
+			if (next.distance < distances[next.vertex]) {
+				distances[next.vertex] = next.distance;
+				bheap_insert(heap, &next);
+
+				if (heap->count > peak)
+					peak = heap->count;
+			}
+		}
+	}
+
+	free_bheap(heap);
+
+	return peak;
+}
+#endif /* ifndef BENCH_GRAPH_H_ */
@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- heapify_bench.c -
+ * bulk load through per-node 'bheap_insert' vs linear-time heapify
+ * ('bheap_insert_array' into an empty heap) across sizes and input orders
+ *
+ * usage: heapify_bench [max length]
+ */
+
+static unsigned long comparisons;
+
+static int compare_key(const void *x,
+		       const void *y)
+{
+	++comparisons;
+	return *((const uint64_t *) x) < *((const uint64_t *) y);
+}
+
+static int compare_qsort(const void *x,
+			 const void *y)
+{
+	const uint64_t key_x = *((const uint64_t *) x);
+	const uint64_t key_y = *((const uint64_t *) y);
+
+	return (key_x > key_y) - (key_x < key_y);
+}
+
+static void fill_keys(uint64_t *keys,
+		      const size_t length,
+		      const char *order)
+{
+	for (size_t i = 0ul; i < length; ++i)
+		keys[i] = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+			| pcg32_random_r(&_RNG);
+
+	if (order[0] == 'r')
+		return;
+
+	qsort(keys, length, sizeof(uint64_t), &compare_qsort);
+
+	if (order[0] == 'd')
+		for (size_t i = 0ul, j = length - 1ul; i < j; ++i, --j)
+			mem_swap(&keys[i], &keys[j], sizeof(uint64_t));
+}
+
+static void heapify_bench(const uint64_t *keys,
+			  const size_t length,
+			  const char *order)
+{
+	struct BHeap *heap = init_sized_bheap(sizeof(uint64_t), length,
+					      &compare_key);
+	uint64_t start;
+	double insert_ns, insert_cmp, heapify_ns, heapify_cmp;
+
+	comparisons = 0ul;
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i)
+		bheap_insert(heap, &keys[i]);
+	insert_ns  = bench_ns_per_op(start, bench_now_ns(), length);
+	insert_cmp = ((double) comparisons) / length;
+
+	clear_bheap(heap);
+
+	comparisons = 0ul;
+	start = bench_now_ns();
+	bheap_insert_array(heap, keys, length);
+	heapify_ns  = bench_ns_per_op(start, bench_now_ns(), length);
+	heapify_cmp = ((double) comparisons) / length;
+
+	printf("%-10s\t%10zu\t%8.2f\t%8.2f\t%8.2f\t%8.2f\t%7.2fx\n",
+	       order, length,
+	       insert_ns, insert_cmp, heapify_ns, heapify_cmp,
+	       insert_ns / heapify_ns);
+
+	free_bheap(heap);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t max_length = (argc > 1)
+				? strtoul(argv[1], NULL, 10)
+				: 10000000ul;
+	static const char *const orders[] = {
+		"random", "sorted", "descending"
+	};
+	uint64_t *keys;
+
+	HANDLE_MALLOC(keys, sizeof(uint64_t) * max_length);
+
+	seed_rng(42u);
+
+	puts("order\t\tlength\t\tinsert ns\tinsert cmp\theapify ns"
+	     "\theapify cmp\tspeedup\t(per node)");
+
+	for (size_t o = 0ul; o < sizeof(orders) / sizeof(orders[0]); ++o)
+		for (size_t length = 1000ul; length <= max_length;
+		     length *= 10ul) {
+			fill_keys(keys, length, orders[o]);
+			heapify_bench(keys, length, orders[o]);
+		}
+
+	free(keys);
+
+	return 0;
+}
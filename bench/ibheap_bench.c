@@ -0,0 +1,230 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <ibheap/ibheap.h>
+#include <bench/bench.h>
+#include <bench/graph.h>
+
+/*			- ibheap_bench.c -
+ * Dijkstra on a random sparse graph: 'struct BHeap' with lazy duplicates
+ * (insert on every relaxation, skip stale entries on extract) vs 'struct
+ * IBHeap' with decrease-key through 'ibheap_update', distances checked to
+ * match.  First, a randomized run of every IBHeap operation against a plain
+ * array model.  Exits with failure if either check does.
+ *
+ * usage: ibheap_bench [vertices] [degree]
+ */
+
+#define CHECK_HANDLES 256ul
+#define CHECK_OPS     100000ul
+
+/* insert, extract, replace (raising or lowering the key) and remove at
+ * random against 'model[handle]' (INFINITE_DISTANCE if not in the heap),
+ * checking every extraction and the count; opens by draining {1, 2}, which
+ * once lost the base node */
+static bool check_ibheap(void)
+{
+	struct IBHeap *heap = init_ibheap(sizeof(struct Entry), &compare_entry);
+	uint64_t model[CHECK_HANDLES];
+	struct Entry next = { 0lu, 0lu };
+	const struct Entry *root;
+	uint64_t best;
+	size_t handle, count = 0ul;
+	bool ok = true;
+
+	for (size_t h = 0ul; h < CHECK_HANDLES; ++h)
+		model[h] = INFINITE_DISTANCE;
+
+	for (uint64_t d = 1lu; d <= 2lu; ++d) {
+		next.distance = d;
+		(void) ibheap_insert(heap, &next);
+	}
+
+	for (uint64_t d = 1lu; d <= 2lu; ++d) {
+		root = ibheap_extract(heap);
+		ok  &= (root != NULL) && (root->distance == d);
+	}
+
+	ok &= (ibheap_extract(heap) == NULL);
+
+	for (size_t op = 0ul; ok && (op < CHECK_OPS); ++op) {
+		handle = rand_uint_upto(CHECK_HANDLES - 1ul);
+
+		switch (rand_uint_upto(4u)) {
+		case 0u:
+		case 1u:
+			if (count == CHECK_HANDLES)
+				break;
+
+			next.distance = rand_uint_upto(1000u);
+			handle	      = ibheap_insert(heap, &next);
+			ok	     &= (model[handle] == INFINITE_DISTANCE);
+			model[handle] = next.distance;
+			++count;
+			/* tag the node with its handle for extraction */
+			((struct Entry *) ibheap_node(heap, handle))->vertex
+				= handle;
+			break;
+
+		case 2u:
+			if (model[handle] == INFINITE_DISTANCE)
+				break;
+
+			next.distance = rand_uint_upto(1000u);
+			next.vertex   = handle;
+			model[handle] = next.distance;
+			ibheap_replace(heap, handle, &next);
+			break;
+
+		case 3u:
+			/* no-op unless 'handle' is in the heap */
+			count	     -= (model[handle] != INFINITE_DISTANCE);
+			model[handle] = INFINITE_DISTANCE;
+			ibheap_remove(heap, handle);
+			break;
+
+		default:
+			best = INFINITE_DISTANCE;
+			for (size_t h = 0ul; h < CHECK_HANDLES; ++h)
+				if (model[h] < best)
+					best = model[h];
+
+			root = ibheap_extract(heap);
+
+			if (root == NULL) {
+				ok &= (count == 0ul);
+				break;
+			}
+
+			ok &= (root->distance == best)
+			   && (model[root->vertex] == best);
+			model[root->vertex] = INFINITE_DISTANCE;
+			--count;
+		}
+
+		ok &= (heap->count == count);
+	}
+
+	free_ibheap(heap);
+
+	return ok;
+}
+
+static size_t indexed_dijkstra(const struct Graph *graph,
+			       uint64_t *distances)
+{
+	struct IBHeap *heap = init_ibheap(sizeof(struct Entry),
+					  &compare_entry);
+	struct Entry next = { 0lu, 0lu };
+	const struct Entry *root;
+	struct Entry *node;
+	size_t *handles;
+	size_t peak = 0ul;
+
+	HANDLE_MALLOC(handles, sizeof(size_t) * graph->count_vertices);
+
+	for (size_t v = 0ul; v < graph->count_vertices; ++v) {
+		distances[v] = INFINITE_DISTANCE;
+		handles[v]   = IBHEAP_NULL_HANDLE;
+	}
+
+	distances[0l] = 0lu;
+	handles[0l]   = ibheap_insert(heap, &next);
+
+	while ((root = ibheap_extract(heap)) != NULL) {
+		const uint64_t vertex	= root->vertex;
+		const uint64_t distance = root->distance;
+
+		handles[vertex] = IBHEAP_NULL_HANDLE;
+
+		for (size_t e = graph->offsets[vertex];
+		     e < graph->offsets[vertex + 1ul]; ++e) {
+			next.distance = distance + graph->weights[e];
+			next.vertex   = graph->targets[e];
+
+			if (next.distance >= distances[next.vertex])
+				continue;
+
+			distances[next.vertex] = next.distance;
+
+			if (handles[next.vertex] == IBHEAP_NULL_HANDLE) {
+				handles[next.vertex] = ibheap_insert(heap,
+								     &next);
+
+				if (heap->count > peak)
+					peak = heap->count;
+			} else {
+				/* decrease-key */
+				node = ibheap_node(heap, handles[next.vertex]);
+				node->distance = next.distance;
+				ibheap_update(heap, handles[next.vertex]);
+			}
+		}
+	}
+
+	free(handles);
+	free_ibheap(heap);
+
+	return peak;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count_vertices = (argc > 1)
+				    ? strtoul(argv[1], NULL, 10)
+				    : 1000000ul;
+	const size_t degree = (argc > 2)
+			    ? strtoul(argv[2], NULL, 10)
+			    : 8ul;
+	struct Graph graph;
+	uint64_t *lazy_distances, *indexed_distances;
+	uint64_t start;
+	double lazy_ms, indexed_ms;
+	size_t lazy_peak, indexed_peak;
+	bool distances_match;
+
+	seed_rng(42u);
+
+	if (!check_ibheap()) {
+		puts("FAILED: IBHeap disagrees with its model");
+		return EXIT_FAILURE;
+	}
+
+	seed_rng(42u);
+	init_graph(&graph, count_vertices, degree);
+
+	HANDLE_MALLOC(lazy_distances,	 sizeof(uint64_t) * count_vertices);
+	HANDLE_MALLOC(indexed_distances, sizeof(uint64_t) * count_vertices);
+
+	start	  = bench_now_ns();
+	lazy_peak = lazy_dijkstra(&graph, lazy_distances);
+	lazy_ms   = (bench_now_ns() - start) / 1e6;
+
+	start	     = bench_now_ns();
+	indexed_peak = indexed_dijkstra(&graph, indexed_distances);
+	indexed_ms   = (bench_now_ns() - start) / 1e6;
+
+	distances_match = (memcmp(lazy_distances, indexed_distances,
+				  sizeof(uint64_t) * count_vertices) == 0);
+
+	printf("%zu vertices, %zu edges\n"
+	       "\t%-8s %12s %12s\n"
+	       "\t%-8s %12.2f %12zu\n"
+	       "\t%-8s %12.2f %12zu\n",
+	       count_vertices, count_vertices * degree,
+	       "heap", "ms", "peak count",
+	       "lazy", lazy_ms, lazy_peak,
+	       "indexed", indexed_ms, indexed_peak);
+
+	free(lazy_distances);
+	free(indexed_distances);
+	free_graph(&graph);
+
+	if (!distances_match) {
+		puts("FAILED: distances differ");
+		return EXIT_FAILURE;
+	}
+
+	return 0;
+}
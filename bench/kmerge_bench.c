@@ -0,0 +1,187 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <kmerge/kmerge.h>
+#include <bench/bench.h>
+
+/*			- kmerge_bench.c -
+ * merging 'k' sorted runs of 16-byte records ('length' in total) into batches
+ * of an output buffer, for k = 2 .. 4096: 'struct KMerge' over the runs in
+ * place, 'struct KMerge' refilling from read callbacks, and inserting every
+ * record into a 'struct BHeap' then extracting it again
+ *
+ * usage: kmerge_bench [length] [batch] [reader capacity]
+ */
+
+struct Source {
+	const struct Record *next;
+	const struct Record *end;
+};
+
+static size_t read_source(void *context,
+			  void *buffer,
+			  const size_t capacity)
+{
+	struct Source *const source = (struct Source *) context;
+	size_t count		    = source->end - source->next;
+
+	if (count > capacity)
+		count = capacity;
+
+	memcpy(buffer, source->next, sizeof(struct Record) * count);
+	source->next += count;
+
+	return count;
+}
+
+/* 'k' runs of ascending keys with random gaps, so all runs interleave */
+static void fill_runs(struct Record *const records,
+		      const size_t length,
+		      const size_t k)
+{
+	const size_t run_length = length / k;
+	uint64_t key;
+
+	for (size_t r = 0ul; r < k; ++r) {
+		key = 0lu;
+
+		for (size_t i = 0ul; i < run_length; ++i) {
+			key += pcg32_random_r(&_RNG) & 0xffffu;
+			records[(r * run_length) + i].key = key;
+			records[(r * run_length) + i].id  = r;
+		}
+	}
+}
+
+static bool check_batch(const struct Record *const batch,
+			const size_t count,
+			uint64_t *const last)
+{
+	bool ordered = true;
+
+	for (size_t i = 0ul; i < count; ++i) {
+		ordered &= (batch[i].key >= *last);
+		*last	 = batch[i].key;
+	}
+
+	return ordered;
+}
+
+static double run_kmerge(const struct Record *const records,
+			 const size_t length,
+			 const size_t k,
+			 struct Record *const out,
+			 const size_t batch,
+			 const size_t capacity,
+			 struct Source *const sources)
+{
+	const size_t run_length = length / k;
+	struct KMerge *merge	= init_kmerge(sizeof(struct Record),
+					      &compare_record);
+	uint64_t start, last	= 0lu;
+	size_t count, total	= 0ul;
+	bool ordered		= true;
+
+	start = bench_now_ns();
+
+	for (size_t r = 0ul; r < k; ++r) {
+		if (sources == NULL) {
+			kmerge_add_buffer(merge, &records[r * run_length],
+					  run_length);
+		} else {
+			sources[r].next = &records[r * run_length];
+			sources[r].end	= &records[(r + 1ul) * run_length];
+			kmerge_add_reader(merge, &read_source, &sources[r],
+					  capacity);
+		}
+	}
+
+	while ((count = kmerge_next(merge, out, batch)) > 0ul) {
+		ordered &= check_batch(out, count, &last);
+		total	+= count;
+	}
+
+	start = bench_now_ns() - start;
+
+	if (!ordered || (total != (run_length * k)))
+		EXIT_ON_FAILURE("kmerge output out of order or short");
+
+	free_kmerge(merge);
+
+	return ((double) start) / (run_length * k);
+}
+
+static double run_bheap(const struct Record *const records,
+			const size_t length,
+			const size_t k,
+			struct Record *const out,
+			const size_t batch)
+{
+	const size_t total  = (length / k) * k;
+	struct BHeap *heap  = init_sized_bheap(sizeof(struct Record), total,
+					       &compare_record);
+	uint64_t start, last = 0lu;
+	size_t count;
+	bool ordered	     = true;
+
+	start = bench_now_ns();
+
+	for (size_t i = 0ul; i < total; ++i)
+		bheap_insert(heap, &records[i]);
+
+	while ((count = bheap_extract_n(heap, out, batch)) > 0ul)
+		ordered &= check_batch(out, count, &last);
+
+	start = bench_now_ns() - start;
+
+	if (!ordered)
+		EXIT_ON_FAILURE("bheap output out of order");
+
+	free_bheap(heap);
+
+	return ((double) start) / total;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 4000000ul;
+	const size_t batch = (argc > 2)
+			   ? strtoul(argv[2], NULL, 10)
+			   : 4096ul;
+	const size_t capacity = (argc > 3)
+			      ? strtoul(argv[3], NULL, 10)
+			      : 256ul;
+	struct Record *records, *out;
+	struct Source *sources;
+
+	HANDLE_MALLOC(records, sizeof(struct Record) * length);
+	HANDLE_MALLOC(out, sizeof(struct Record) * batch);
+	HANDLE_MALLOC(sources, sizeof(struct Source) * 4096ul);
+
+	printf("%zu records, batches of %zu, reader capacity %zu "
+	       "(ns per record)\n"
+	       "\t%6s %12s %12s %12s\n",
+	       length, batch, capacity, "k", "buffers", "readers", "bheap");
+
+	for (size_t k = 2ul; k <= 4096ul; k *= 2ul) {
+		seed_rng(42u);
+		fill_runs(records, length, k);
+
+		printf("\t%6zu %12.2f %12.2f %12.2f\n",
+		       k,
+		       run_kmerge(records, length, k, out, batch, capacity,
+				  NULL),
+		       run_kmerge(records, length, k, out, batch, capacity,
+				  sources),
+		       run_bheap(records, length, k, out, batch));
+	}
+
+	free(sources);
+	free(out);
+	free(records);
+
+	return 0;
+}
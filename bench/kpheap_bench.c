@@ -0,0 +1,121 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <kpheap/kpheap.h>
+#include <bench/bench.h>
+
+/*			- kpheap_bench.c -
+ * inserting then extracting 'length' wide records (8-byte key + payload):
+ * whole records in a 'struct BHeap' vs keys in a 'struct KPHeap' with the
+ * payloads in its slab
+ *
+ * usage: kpheap_bench [length]
+ */
+
+#define MAX_WIDTH 512ul
+
+/* records and keys both lead with a uint64_t key */
+static int compare_key(const void *x,
+		       const void *y)
+{
+	return *((const uint64_t *) x) < *((const uint64_t *) y);
+}
+
+static double run_bheap(const char *records,
+			const size_t length,
+			const size_t width,
+			uint64_t *checksum)
+{
+	struct BHeap *heap = init_sized_bheap(width, length, &compare_key);
+	char out[MAX_WIDTH];
+	const uint64_t start = bench_now_ns();
+
+	for (size_t i = 0ul; i < length; ++i)
+		bheap_insert(heap, &records[i * width]);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		memcpy(&out[0l], bheap_extract(heap), width);
+		*checksum += out[width - 1ul] + *((uint64_t *) &out[0l]);
+	}
+
+	const uint64_t stop = bench_now_ns();
+
+	free_bheap(heap);
+
+	return bench_ns_per_op(start, stop, length);
+}
+
+static double run_kpheap(const char *records,
+			 const size_t length,
+			 const size_t width,
+			 uint64_t *checksum)
+{
+	const size_t key_width = sizeof(uint64_t);
+	struct KPHeap *heap = init_sized_dary_kpheap(key_width,
+						     width - key_width,
+						     length, BHEAP_ARITY,
+						     &compare_key);
+	char out[MAX_WIDTH];
+	const uint64_t start = bench_now_ns();
+
+	for (size_t i = 0ul; i < length; ++i)
+		kpheap_insert(heap, &records[i * width],
+			      &records[(i * width) + key_width]);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		(void) kpheap_extract(heap, &out[0l], &out[key_width]);
+		*checksum += out[width - 1ul] + *((uint64_t *) &out[0l]);
+	}
+
+	const uint64_t stop = bench_now_ns();
+
+	free_kpheap(heap);
+
+	return bench_ns_per_op(start, stop, length);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 200000ul;
+	uint64_t bheap_checksum, kpheap_checksum;
+	double bheap_ns, kpheap_ns;
+	char *records;
+
+	HANDLE_MALLOC(records, MAX_WIDTH * length);
+
+	puts("width\tlength\t\tbheap ns/node\tkpheap ns/node\tspeedup");
+
+	for (size_t width = 32ul; width <= MAX_WIDTH; width *= 2ul) {
+		seed_rng(42u);
+		for (size_t i = 0ul; i < length; ++i) {
+			*((uint64_t *) &records[i * width])
+			= pcg32_random_r(&_RNG);
+			memset(&records[(i * width) + sizeof(uint64_t)],
+			       (int) (i & 0x7f), width - sizeof(uint64_t));
+		}
+
+		bheap_checksum	= 0lu;
+		kpheap_checksum = 0lu;
+
+		bheap_ns  = run_bheap(records, length, width,
+				      &bheap_checksum);
+		kpheap_ns = run_kpheap(records, length, width,
+				       &kpheap_checksum);
+
+		if (bheap_checksum != kpheap_checksum) {
+			puts("FAILED: checksum mismatch");
+			return EXIT_FAILURE;
+		}
+
+		printf("%zu\t%10zu\t%13.2f\t%14.2f\t%7.2fx\n",
+		       width, length, bheap_ns, kpheap_ns,
+		       bheap_ns / kpheap_ns);
+	}
+
+	free(records);
+
+	return 0;
+}
@@ -0,0 +1,144 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- lazy_bench.c -
+ * bursty producer/consumer trace over a heap of 'steady' 16-byte records:
+ * each round a producer pushes a burst of about 'burst' records (uniformly
+ * between half and one and a half times that) and a consumer then pops as
+ * many.  'bheap_insert' vs 'bheap_insert_lazy' (flushed by the first pop),
+ * with no flush limit and with a limit of 'burst / 4', for uniform keys and
+ * for descending keys (each burst sorts before everything queued, the worst
+ * case for shifting up), reporting ns per record pushed and popped.
+ *
+ * usage: lazy_bench [steady] [records per run]
+ */
+
+enum LazyMode {
+	LAZY_EAGER,
+	LAZY_UNLIMITED,
+	LAZY_LIMITED,
+	LAZY_COUNT_MODE
+};
+
+static const char *const mode_names[LAZY_COUNT_MODE] = {
+	"eager", "lazy", "lazy/4"
+};
+
+static const size_t bursts[] = { 16ul, 256ul, 4096ul, 65536ul, 1048576ul };
+
+static inline uint64_t next_key(const bool descending,
+				uint64_t *const floor)
+{
+	if (descending)
+		return --(*floor);
+
+	return (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+	     | pcg32_random_r(&_RNG);
+}
+
+static double run_trace(const enum LazyMode mode,
+			const bool descending,
+			const size_t steady,
+			const size_t burst,
+			const size_t total,
+			uint64_t *const checksum)
+{
+	struct BHeap *heap = init_bheap(sizeof(struct Record),
+					&compare_record);
+	uint64_t floor	   = UINT64_MAX;
+	size_t moved	   = 0ul;
+	struct Record next = { .id = 0lu };
+	uint64_t start, elapsed;
+	size_t length;
+
+	seed_rng(42u);
+
+	for (size_t i = 0ul; i < steady; ++i) {
+		next.key = next_key(descending, &floor);
+		++(next.id);
+		bheap_insert(heap, &next);
+	}
+
+	if (mode == LAZY_LIMITED)
+		set_bheap_flush_limit(heap, (burst < 4ul) ? 1ul : (burst / 4ul));
+
+	*checksum = 0lu;
+
+	start = bench_now_ns();
+	while (moved < total) {
+		length = (burst / 2ul) + (pcg32_random_r(&_RNG) % (burst + 1ul));
+
+		for (size_t i = 0ul; i < length; ++i) {
+			next.key = next_key(descending, &floor);
+			++(next.id);
+
+			if (mode == LAZY_EAGER)
+				bheap_insert(heap, &next);
+			else
+				bheap_insert_lazy(heap, &next);
+		}
+
+		for (size_t i = 0ul; i < length; ++i)
+			*checksum += ((const struct Record *)
+				      bheap_extract(heap))->id;
+
+		moved += length;
+	}
+	elapsed = bench_now_ns() - start;
+
+	free_bheap(heap);
+
+	return ((double) elapsed) / (2ul * moved);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t steady = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 100000ul;
+	const size_t total  = (argc > 2)
+			    ? strtoul(argv[2], NULL, 10)
+			    : 4000000ul;
+	const size_t count_bursts = sizeof(bursts) / sizeof(bursts[0]);
+	uint64_t checksums[LAZY_COUNT_MODE];
+	double ns_op;
+
+	printf("steady %zu records, %zu pushed and popped per run (ns/record)\n"
+	       "%-11s %9s",
+	       steady, total, "keys", "burst");
+
+	for (int m = 0; m < LAZY_COUNT_MODE; ++m)
+		printf(" %10s", mode_names[m]);
+
+	putchar('\n');
+
+	for (int descending = 0; descending < 2; ++descending) {
+		for (size_t b = 0ul; b < count_bursts; ++b) {
+			printf("%-11s %9zu",
+			       descending ? "descending" : "uniform",
+			       bursts[b]);
+
+			for (int m = 0; m < LAZY_COUNT_MODE; ++m) {
+				ns_op = run_trace((enum LazyMode) m,
+						  descending != 0,
+						  steady, bursts[b], total,
+						  &checksums[m]);
+				printf(" %10.2f", ns_op);
+			}
+
+			if ((checksums[LAZY_UNLIMITED] != checksums[LAZY_EAGER])
+			    || (checksums[LAZY_LIMITED]
+				!= checksums[LAZY_EAGER])) {
+				puts("\nFAILED: popped records differ");
+				return EXIT_FAILURE;
+			}
+
+			putchar('\n');
+		}
+	}
+
+	return 0;
+}
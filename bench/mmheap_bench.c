@@ -0,0 +1,185 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <mmheap/mmheap.h>
+#include <bench/bench.h>
+
+/*			- mmheap_bench.c -
+ * bounded buffer of at most 'capacity' 16-byte records under 'ops' rounds of
+ * insert one, evict the worst while over capacity, and (every other round)
+ * pop the best: 'struct MMHeap' vs a pair of 'struct BHeap's (one per end)
+ * kept in sync by record id, each skipping records already taken from the
+ * other end as they surface.  Then bulk builds of 'capacity' records:
+ * 'mmheap_insert_array' vs 'bheap_insert_array' into both of the pair.
+ *
+ * usage: mmheap_bench [capacity] [ops]
+ */
+
+static int compare_max(const void *x,
+		       const void *y)
+{
+	return ((const struct Record *) x)->key
+	     > ((const struct Record *) y)->key;
+}
+
+static inline uint64_t next_key(void)
+{
+	return (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+	     | pcg32_random_r(&_RNG);
+}
+
+static void run_mmheap(const size_t capacity,
+		       const size_t ops)
+{
+	struct MMHeap *heap = init_mmheap(sizeof(struct Record), &compare_record);
+	uint64_t checksum   = 0lu;
+	struct Record next;
+	uint64_t start, elapsed;
+
+	seed_rng(42u);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < ops; ++i) {
+		next.key = next_key();
+		next.id	 = i;
+		mmheap_insert(heap, &next);
+
+		if (mmheap_count(heap) > capacity)
+			checksum += ((const struct Record *)
+				     mmheap_extract_max(heap))->key;
+
+		if ((i & 1ul) != 0ul)
+			checksum -= ((const struct Record *)
+				     mmheap_extract_min(heap))->key;
+	}
+	elapsed = bench_now_ns() - start;
+
+	printf("\t%-8s %12.2f %12zu %20lu\n",
+	       "mmheap", ((double) elapsed) / ops,
+	       bheap_peak_bytes(heap->heap) + sizeof(struct MMHeap),
+	       (unsigned long) checksum);
+
+	free_mmheap(heap);
+}
+
+/* extracts from 'heap' the best record not yet taken from the other end */
+static const struct Record *pop_live(struct BHeap *heap,
+				     bool *const taken)
+{
+	const struct Record *record;
+
+	do {
+		record = (const struct Record *) bheap_extract(heap);
+	} while (taken[record->id]);
+
+	taken[record->id] = true;
+
+	return record;
+}
+
+static void run_paired(const size_t capacity,
+		       const size_t ops)
+{
+	struct BHeap *min = init_bheap(sizeof(struct Record), &compare_record);
+	struct BHeap *max = init_bheap(sizeof(struct Record), &compare_max);
+	uint64_t checksum = 0lu;
+	size_t count	  = 0ul;
+	struct Record next;
+	uint64_t start, elapsed;
+	bool *taken;
+
+	HANDLE_CALLOC(taken, ops, sizeof(bool));
+
+	seed_rng(42u);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < ops; ++i) {
+		next.key = next_key();
+		next.id	 = i;
+		bheap_insert(min, &next);
+		bheap_insert(max, &next);
+		++count;
+
+		if (count > capacity) {
+			checksum += pop_live(max, taken)->key;
+			--count;
+		}
+
+		if ((i & 1ul) != 0ul) {
+			checksum -= pop_live(min, taken)->key;
+			--count;
+		}
+	}
+	elapsed = bench_now_ns() - start;
+
+	printf("\t%-8s %12.2f %12zu %20lu\n",
+	       "paired", ((double) elapsed) / ops,
+	       bheap_peak_bytes(min) + bheap_peak_bytes(max)
+	       + (sizeof(bool) * ops),
+	       (unsigned long) checksum);
+
+	free(taken);
+	free_bheap(max);
+	free_bheap(min);
+}
+
+static void run_build(const size_t length)
+{
+	struct MMHeap *heap = init_mmheap(sizeof(struct Record), &compare_record);
+	struct BHeap *min   = init_bheap(sizeof(struct Record), &compare_record);
+	struct BHeap *max   = init_bheap(sizeof(struct Record), &compare_max);
+	struct Record *records;
+	uint64_t start, mm_ns, paired_ns;
+
+	HANDLE_MALLOC(records, sizeof(struct Record) * length);
+
+	seed_rng(42u);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		records[i].key = next_key();
+		records[i].id  = i;
+	}
+
+	start = bench_now_ns();
+	mmheap_insert_array(heap, records, length);
+	mm_ns = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	bheap_insert_array(min, records, length);
+	bheap_insert_array(max, records, length);
+	paired_ns = bench_now_ns() - start;
+
+	printf("bulk build of %zu records (ns/record)\n"
+	       "\t%-8s %12.2f\n"
+	       "\t%-8s %12.2f\n",
+	       length,
+	       "mmheap", ((double) mm_ns) / length,
+	       "paired", ((double) paired_ns) / length);
+
+	free(records);
+	free_bheap(max);
+	free_bheap(min);
+	free_mmheap(heap);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t capacity = (argc > 1)
+			      ? strtoul(argv[1], NULL, 10)
+			      : 100000ul;
+	const size_t ops      = (argc > 2)
+			      ? strtoul(argv[2], NULL, 10)
+			      : 10000000ul;
+
+	printf("capacity %zu, %zu rounds\n"
+	       "\t%-8s %12s %12s %20s\n",
+	       capacity, ops,
+	       "queue", "ns/round", "peak bytes", "checksum");
+
+	run_mmheap(capacity, ops);
+	run_paired(capacity, ops);
+	run_build(capacity);
+
+	return 0;
+}
@@ -0,0 +1,255 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <mqueue/mqueue.h>
+#include <bench/bench.h>
+
+/*			- mqueue_bench.c -
+ * 1. throughput: 'T' threads alternating extract / insert on a prefilled
+ *    queue, MultiQueue ('c = 2' shards per thread) vs one 'struct BHeap'
+ *    behind one mutex
+ * 2. quality: rank error of MultiQueue extractions (count of smaller keys
+ *    present at extraction time) for several shard counts, tracked with a
+ *    Fenwick tree over the key space
+ *
+ * usage: mqueue_bench [max threads] [ops per thread] [prefill]
+ */
+
+#define KEY_BITS  20u
+#define KEY_SPACE (1ul << KEY_BITS)
+
+static int compare_key(const void *x,
+		       const void *y)
+{
+	return *((const uint64_t *) x) < *((const uint64_t *) y);
+}
+
+
+/* throughput
+ ******************************************************************************/
+struct Locked {
+	pthread_mutex_t lock;
+	struct BHeap *heap;
+};
+
+struct Worker {
+	pthread_t thread;
+	pcg32_random_t rng;
+	size_t ops;
+	struct MQueue *queue;
+	struct Locked *locked;
+	uint64_t checksum;
+};
+
+static void *run_mqueue(void *arg)
+{
+	struct Worker *worker = (struct Worker *) arg;
+	uint64_t key = 0lu;
+
+	for (size_t i = 0ul; i < worker->ops; ++i) {
+		if (mqueue_extract(worker->queue, &worker->rng, &key))
+			worker->checksum += key;
+
+		key += pcg32_boundedrand_r(&worker->rng, KEY_SPACE);
+		mqueue_insert(worker->queue, &worker->rng, &key);
+	}
+
+	return NULL;
+}
+
+static void *run_locked(void *arg)
+{
+	struct Worker *worker = (struct Worker *) arg;
+	struct Locked *locked = worker->locked;
+	uint64_t key = 0lu;
+	uint64_t next;
+
+	for (size_t i = 0ul; i < worker->ops; ++i) {
+		next = pcg32_boundedrand_r(&worker->rng, KEY_SPACE);
+
+		pthread_mutex_lock(&locked->lock);
+		if (locked->heap->count > 0ul) {
+			key = *((uint64_t *) bheap_extract(locked->heap));
+			worker->checksum += key;
+		}
+		next += key;
+		bheap_insert(locked->heap, &next);
+		pthread_mutex_unlock(&locked->lock);
+	}
+
+	return NULL;
+}
+
+/* returns ns per operation pair (one extract + one insert) */
+static double run_threads(struct Worker *workers,
+			  const size_t count_threads,
+			  void *(*routine)(void *))
+{
+	const uint64_t start = bench_now_ns();
+
+	for (size_t t = 0ul; t < count_threads; ++t)
+		if (pthread_create(&workers[t].thread, NULL, routine,
+				   &workers[t]) != 0)
+			EXIT_ON_FAILURE("failed to create thread %lu", t);
+
+	for (size_t t = 0ul; t < count_threads; ++t)
+		pthread_join(workers[t].thread, NULL);
+
+	return bench_ns_per_op(start, bench_now_ns(),
+			       workers[0].ops * count_threads);
+}
+
+static void bench_throughput(struct Worker *workers,
+			     const size_t max_threads,
+			     const size_t ops,
+			     const size_t prefill)
+{
+	struct MQueue *queue;
+	struct Locked locked;
+	uint64_t key;
+	double mqueue_ns, locked_ns;
+
+	puts("threads\tshards\tmqueue ns/op\tlocked ns/op\tspeedup");
+
+	for (size_t count_threads = 1ul;
+	     count_threads <= max_threads;
+	     count_threads *= 2ul) {
+		queue = init_mqueue(sizeof(uint64_t), 2ul * count_threads,
+				    &compare_key);
+		pthread_mutex_init(&locked.lock, NULL);
+		locked.heap = init_bheap(sizeof(uint64_t), &compare_key);
+
+		for (size_t t = 0ul; t < count_threads; ++t) {
+			pcg32_srandom_r(&workers[t].rng, 42u, t);
+			workers[t].ops	    = ops;
+			workers[t].queue    = queue;
+			workers[t].locked   = &locked;
+			workers[t].checksum = 0lu;
+		}
+
+		for (size_t i = 0ul; i < prefill; ++i) {
+			key = pcg32_boundedrand_r(&workers[0].rng, KEY_SPACE);
+			mqueue_insert(queue, &workers[0].rng, &key);
+			bheap_insert(locked.heap, &key);
+		}
+
+		mqueue_ns = run_threads(workers, count_threads, &run_mqueue);
+		locked_ns = run_threads(workers, count_threads, &run_locked);
+
+		printf("%zu\t%zu\t%12.2f\t%12.2f\t%7.2fx\n",
+		       count_threads, queue->count_shards, mqueue_ns,
+		       locked_ns, locked_ns / mqueue_ns);
+
+		free_mqueue(queue);
+		free_bheap(locked.heap);
+		pthread_mutex_destroy(&locked.lock);
+	}
+}
+
+
+/* quality
+ ******************************************************************************/
+/* Fenwick tree over KEY_SPACE: tree[i] counts present keys in a range
+ * ending at key 'i - 1' */
+static void fenwick_add(long *tree,
+			uint64_t key,
+			const long delta)
+{
+	for (++key; key <= KEY_SPACE; key += key & (~key + 1lu))
+		tree[key] += delta;
+}
+
+/* count of present keys < 'key' */
+static long fenwick_rank(const long *tree,
+			 uint64_t key)
+{
+	long rank = 0l;
+
+	for (; key > 0lu; key &= key - 1lu)
+		rank += tree[key];
+
+	return rank;
+}
+
+static void bench_quality(const size_t ops,
+			  const size_t prefill)
+{
+	const size_t count_shards[] = { 1ul, 4ul, 8ul, 16ul, 32ul, 64ul };
+	struct MQueue *queue;
+	pcg32_random_t rng;
+	long *tree;
+	uint64_t key;
+	long rank, max_rank;
+	double sum_rank;
+
+	HANDLE_MALLOC(tree, sizeof(long) * (KEY_SPACE + 1ul));
+
+	puts("\nshards\tmean rank error\tmax rank error");
+
+	for (size_t s = 0ul;
+	     s < (sizeof(count_shards) / sizeof(count_shards[0]));
+	     ++s) {
+		memset(tree, 0, sizeof(long) * (KEY_SPACE + 1ul));
+		pcg32_srandom_r(&rng, 42u, 54u);
+		queue = init_mqueue(sizeof(uint64_t), count_shards[s],
+				    &compare_key);
+
+		for (size_t i = 0ul; i < prefill; ++i) {
+			key = pcg32_boundedrand_r(&rng, KEY_SPACE);
+			mqueue_insert(queue, &rng, &key);
+			fenwick_add(tree, key, 1l);
+		}
+
+		sum_rank = 0.0;
+		max_rank = 0l;
+
+		for (size_t i = 0ul; i < ops; ++i) {
+			(void) mqueue_extract(queue, &rng, &key);
+			fenwick_add(tree, key, -1l);
+
+			rank	  = fenwick_rank(tree, key);
+			sum_rank += (double) rank;
+			if (rank > max_rank)
+				max_rank = rank;
+
+			key = pcg32_boundedrand_r(&rng, KEY_SPACE);
+			mqueue_insert(queue, &rng, &key);
+			fenwick_add(tree, key, 1l);
+		}
+
+		printf("%zu\t%15.2f\t%14ld\n",
+		       count_shards[s], sum_rank / ops, max_rank);
+
+		free_mqueue(queue);
+	}
+
+	free(tree);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t max_threads = (argc > 1)
+				 ? strtoul(argv[1], NULL, 10)
+				 : 8ul;
+	const size_t ops = (argc > 2)
+			 ? strtoul(argv[2], NULL, 10)
+			 : 1000000ul;
+	const size_t prefill = (argc > 3)
+			     ? strtoul(argv[3], NULL, 10)
+			     : 100000ul;
+	struct Worker *workers;
+
+	if (max_threads == 0ul)
+		EXIT_ON_FAILURE("max threads must be positive");
+
+	HANDLE_MALLOC(workers, sizeof(struct Worker) * max_threads);
+
+	bench_throughput(workers, max_threads, ops, prefill);
+	bench_quality(ops, prefill);
+
+	free(workers);
+
+	return 0;
+}
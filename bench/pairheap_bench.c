@@ -0,0 +1,206 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <pairheap/pairheap.h>
+#include <bench/bench.h>
+
+/*			- pairheap_bench.c -
+ * consolidating 'shards' queues of 'shard length' random 16-byte records into
+ * one: 'struct BHeap' shards drained into the first through
+ * 'bheap_insert_array' vs 'struct PairHeap' shards (one pool) melded into the
+ * first.  Reports ns per insertion while filling the shards, total time to
+ * consolidate, and ns per extraction draining the result (checked to match).
+ * Then decrease-key: every node of one pairing heap of 'shard length' nodes
+ * lowered once in random order, and the heap drained and checked for order.
+ *
+ * usage: pairheap_bench [shards] [shard length]
+ */
+
+static inline void next_record(struct Record *record,
+			       const size_t id)
+{
+	record->key = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+		    | pcg32_random_r(&_RNG);
+	record->id  = id;
+}
+
+static void bench_bheap(const size_t count_shards,
+			const size_t shard_length)
+{
+	const size_t length = count_shards * shard_length;
+	struct BHeap **shards;
+	struct Record next;
+	const struct Record *top;
+	uint64_t start, checksum = 0lu;
+	double insert_ns, meld_us, extract_ns;
+
+	HANDLE_MALLOC(shards, sizeof(struct BHeap *) * count_shards);
+
+	seed_rng(42u);
+
+	start = bench_now_ns();
+	for (size_t s = 0ul; s < count_shards; ++s) {
+		shards[s] = init_bheap(sizeof(struct Record), &compare_record);
+
+		for (size_t i = 0ul; i < shard_length; ++i) {
+			next_record(&next, (s * shard_length) + i);
+			bheap_insert(shards[s], &next);
+		}
+	}
+	insert_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	start = bench_now_ns();
+	for (size_t s = 1ul; s < count_shards; ++s) {
+		bheap_insert_array(shards[0l],
+				   &shards[s]->nodes[shards[s]->width],
+				   shards[s]->count);
+		clear_bheap(shards[s]);
+	}
+	meld_us = (bench_now_ns() - start) / 1e3;
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		top	 = (const struct Record *) bheap_extract(shards[0l]);
+		checksum = (checksum * 31lu) + top->id;
+	}
+	extract_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	printf("%-9s %12.2f %12.1f %12.2f %20lu\n", "bheap",
+	       insert_ns, meld_us, extract_ns, (unsigned long) checksum);
+
+	for (size_t s = 0ul; s < count_shards; ++s)
+		free_bheap(shards[s]);
+
+	free(shards);
+}
+
+static void bench_pairheap(const size_t count_shards,
+			   const size_t shard_length)
+{
+	const size_t length = count_shards * shard_length;
+	struct PairPool *pool;
+	struct PairHeap **shards;
+	struct Record next;
+	const struct Record *top;
+	uint64_t start, checksum = 0lu;
+	double insert_ns, meld_us, extract_ns;
+
+	HANDLE_MALLOC(shards, sizeof(struct PairHeap *) * count_shards);
+
+	pool = init_pairpool(sizeof(struct Record), &compare_record);
+
+	seed_rng(42u);
+
+	start = bench_now_ns();
+	for (size_t s = 0ul; s < count_shards; ++s) {
+		shards[s] = init_pairheap(pool);
+
+		for (size_t i = 0ul; i < shard_length; ++i) {
+			next_record(&next, (s * shard_length) + i);
+			(void) pairheap_insert(shards[s], &next);
+		}
+	}
+	insert_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	start = bench_now_ns();
+	for (size_t s = 1ul; s < count_shards; ++s)
+		pairheap_meld(shards[0l], shards[s]);
+	meld_us = (bench_now_ns() - start) / 1e3;
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		top	 = (const struct Record *) pairheap_extract(shards[0l]);
+		checksum = (checksum * 31lu) + top->id;
+	}
+	extract_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	printf("%-9s %12.2f %12.1f %12.2f %20lu\n", "pairheap",
+	       insert_ns, meld_us, extract_ns, (unsigned long) checksum);
+
+	for (size_t s = 0ul; s < count_shards; ++s)
+		free_pairheap(shards[s]);
+
+	free_pairpool(pool);
+	free(shards);
+}
+
+static void bench_decrease_key(const size_t length)
+{
+	struct PairPool *pool;
+	struct PairHeap *heap;
+	struct Record next, *node;
+	size_t *handles, j, swap;
+	uint64_t start, last = 0lu;
+	double decrease_ns;
+	bool ordered = true;
+
+	HANDLE_MALLOC(handles, sizeof(size_t) * length);
+
+	pool = init_sized_pairpool(sizeof(struct Record), length,
+				   &compare_record);
+	heap = init_pairheap(pool);
+
+	seed_rng(42u);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		next_record(&next, i);
+		handles[i] = pairheap_insert(heap, &next);
+	}
+
+	/* shuffle so that cuts land all over the tree */
+	for (size_t i = length - 1ul; i > 0ul; --i) {
+		j	   = pcg32_boundedrand_r(&_RNG, (uint32_t) (i + 1ul));
+		swap	   = handles[i];
+		handles[i] = handles[j];
+		handles[j] = swap;
+	}
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		node	   = (struct Record *) pairheap_node(heap, handles[i]);
+		node->key /= 2lu;
+		pairheap_decrease_key(heap, handles[i]);
+	}
+	decrease_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		node = (struct Record *) pairheap_extract(heap);
+
+		if (node->key < last)
+			ordered = false;
+
+		last = node->key;
+	}
+
+	if (!ordered)
+		EXIT_ON_FAILURE("pairing heap drained out of order");
+
+	printf("\ndecrease-key: %zu nodes %8.2f ns/op\n", length,
+	       decrease_ns);
+
+	free_pairheap(heap);
+	free_pairpool(pool);
+	free(handles);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count_shards = (argc > 1)
+				  ? strtoul(argv[1], NULL, 10)
+				  : 64ul;
+	const size_t shard_length = (argc > 2)
+				  ? strtoul(argv[2], NULL, 10)
+				  : 65536ul;
+
+	printf("%zu shards of %zu records\n"
+	       "%-9s %12s %12s %12s %20s\n",
+	       count_shards, shard_length,
+	       "queue", "insert ns", "merge us", "extract ns", "checksum");
+
+	bench_bheap(count_shards, shard_length);
+	bench_pairheap(count_shards, shard_length);
+	bench_decrease_key(shard_length);
+
+	return 0;
+}
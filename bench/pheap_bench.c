@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE		/* syscall */
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <pheap/pheap.h>
+#include <bench/bench.h>
+
+#ifdef __linux__
+#include <unistd.h>		/* syscall, read, close */
+#include <sys/ioctl.h>		/* ioctl */
+#include <sys/syscall.h>	/* SYS_perf_event_open */
+#include <linux/perf_event.h>	/* struct perf_event_attr */
+#endif /* ifdef __linux__ */
+
+/*			- pheap_bench.c -
+ * flat 'struct BHeap' (binary) vs page-aware 'struct PHeap' (4 KiB and 2 MiB
+ * pages) on heaps of 16-byte records well past TLB reach: 'length' random
+ * insertions, then as many extractions, reporting ns and dTLB load misses per
+ * operation.  Misses are read through perf_event_open and shown as "n/a" where
+ * counters are unavailable (non-Linux, 'perf_event_paranoid' too high, or no
+ * PMU under virtualization).  As a machine-independent proxy, extraction also
+ * reports page switches: heap nodes read by the comparator that lie on a
+ * different 4 KiB page from the heap node read before them.
+ *
+ * usage: pheap_bench [length...]
+ */
+
+enum Layout {
+	LAYOUT_FLAT,
+	LAYOUT_PAGE,
+	LAYOUT_HUGE_PAGE,
+	LAYOUT_COUNT
+};
+
+static const char *const layout_names[LAYOUT_COUNT] = {
+	"flat", "page 4K", "page 2M"
+};
+
+static const size_t default_lengths[] = { 1ul << 16, 1ul << 20, 1ul << 23 };
+
+/* node array being traced, empty range while inserting (it may move) */
+static uintptr_t trace_lo, trace_hi;
+static uintptr_t last_page;
+static size_t page_switches;
+
+static inline void touch_page(const void *const node)
+{
+	const uintptr_t address = (uintptr_t) node;
+
+	if ((address < trace_lo) || (address >= trace_hi))
+		return;
+
+	page_switches += ((address >> 12) != last_page);
+	last_page      = address >> 12;
+}
+
+static int compare_traced(const void *x,
+			  const void *y)
+{
+	touch_page(x);
+	touch_page(y);
+
+	return compare_record(x, y);
+}
+
+
+/* dTLB load miss counter for this thread, -1 if unavailable
+ ******************************************************************************/
+static int open_tlb_counter(void)
+{
+#ifdef __linux__
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+
+	attr.type	    = PERF_TYPE_HW_CACHE;
+	attr.size	    = sizeof(attr);
+	attr.config	    = PERF_COUNT_HW_CACHE_DTLB
+			    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+			    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.disabled	    = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv	    = 1;
+
+	return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0ul);
+#else
+	return -1;
+#endif /* ifdef __linux__ */
+}
+
+static void start_counter(const int fd)
+{
+#ifdef __linux__
+	if (fd >= 0) {
+		(void) ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		(void) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+#else
+	(void) fd;
+#endif /* ifdef __linux__ */
+}
+
+/* -1.0 if unavailable */
+static double stop_counter(const int fd)
+{
+#ifdef __linux__
+	uint64_t count;
+
+	if (fd < 0)
+		return -1.0;
+
+	(void) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+	if (read(fd, &count, sizeof(count)) != (ssize_t) sizeof(count))
+		return -1.0;
+
+	return (double) count;
+#else
+	(void) fd;
+	return -1.0;
+#endif /* ifdef __linux__ */
+}
+
+
+/* run
+ ******************************************************************************/
+static void print_cell(const uint64_t elapsed,
+		       const double misses,
+		       const size_t length)
+{
+	printf(" %9.2f", ((double) elapsed) / length);
+
+	if (misses < 0.0)
+		printf(" %9s", "n/a");
+	else
+		printf(" %9.3f", misses / length);
+}
+
+static void run_layout(const enum Layout layout,
+		       const size_t length,
+		       const int counter)
+{
+	struct BHeap *flat  = NULL;
+	struct PHeap *paged = NULL;
+	uint64_t checksum   = 0lu;
+	struct Record next;
+	const struct Record *top;
+	uint64_t start, elapsed;
+	double misses;
+
+	if (layout == LAYOUT_FLAT)
+		flat = init_bheap(sizeof(struct Record), &compare_traced);
+	else
+		paged = init_paged_pheap(sizeof(struct Record),
+					 (layout == LAYOUT_PAGE)
+					 ? PHEAP_PAGE_BYTES
+					 : PHEAP_HUGE_PAGE_BYTES,
+					 &compare_traced);
+
+	seed_rng(42u);
+
+	printf("%-9s %10zu", layout_names[layout], length);
+
+	trace_lo = trace_hi = 0lu;
+	start_counter(counter);
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		next.key = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+			 | pcg32_random_r(&_RNG);
+		next.id	 = i;
+
+		if (flat != NULL)
+			bheap_insert(flat, &next);
+		else
+			pheap_insert(paged, &next);
+	}
+	elapsed = bench_now_ns() - start;
+	misses	= stop_counter(counter);
+
+	print_cell(elapsed, misses, length);
+
+	if (flat != NULL) {
+		trace_lo = (uintptr_t) flat->block;
+		trace_hi = trace_lo + bheap_block_size(flat->width,
+						       flat->alloc);
+	} else {
+		trace_lo = (uintptr_t) paged->nodes;
+		trace_hi = trace_lo + (paged->alloc
+				       * (paged->width << paged->log_page));
+	}
+
+	page_switches = 0ul;
+	last_page     = 0lu;
+	start_counter(counter);
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		top = (const struct Record *) ((flat != NULL)
+					       ? bheap_extract(flat)
+					       : pheap_extract(paged));
+		checksum = (checksum * 31lu) + top->id;
+	}
+	elapsed = bench_now_ns() - start;
+	misses	= stop_counter(counter);
+
+	print_cell(elapsed, misses, length);
+
+	printf(" %9.2f %20lu\n",
+	       ((double) page_switches) / length, (unsigned long) checksum);
+
+	if (flat != NULL)
+		free_bheap(flat);
+	else
+		free_pheap(paged);
+}
+
+int main(int argc, char *argv[])
+{
+	const int counter = open_tlb_counter();
+	size_t count_lengths;
+	size_t length;
+
+	count_lengths = (argc > 1)
+		      ? ((size_t) (argc - 1))
+		      : (sizeof(default_lengths) / sizeof(default_lengths[0]));
+
+	if (counter < 0)
+		puts("dTLB counter unavailable: misses shown as n/a");
+
+	printf("%-9s %10s %9s %9s %9s %9s %9s %20s\n",
+	       "layout", "length", "ins ns", "ins tlb",
+	       "ext ns", "ext tlb", "ext pages", "checksum");
+
+	for (size_t l = 0ul; l < count_lengths; ++l) {
+		length = (argc > 1)
+		       ? strtoul(argv[l + 1ul], NULL, 10)
+		       : default_lengths[l];
+
+		for (int layout = 0; layout < LAYOUT_COUNT; ++layout)
+			run_layout((enum Layout) layout, length, counter);
+	}
+
+#ifdef __linux__
+	if (counter >= 0)
+		close(counter);
+#endif /* ifdef __linux__ */
+
+	return 0;
+}
@@ -0,0 +1,99 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <pheapify/pheapify.h>
+#include <bench/bench.h>
+
+/*			- pheapify_bench.c -
+ * building a heap from 'length' random 16-byte records: 'array_into_bheap' vs
+ * 'parray_into_dary_bheap' at 1, 2, 4, ... up to 'max threads' threads, each
+ * result checked for heap order and against the serial heap node for node
+ *
+ * usage: pheapify_bench [length] [max threads]
+ */
+
+static bool is_heap(const struct BHeap *heap)
+{
+	const struct Record *const nodes = (const struct Record *) heap->nodes;
+
+	for (ptrdiff_t i = 2l; i <= (ptrdiff_t) heap->count; ++i)
+		if (compare_record(&nodes[i],
+				   &nodes[bheap_i_parent(i, heap->log_arity)]))
+			return false;
+
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 16000000ul;
+	const size_t max_threads = (argc > 2)
+				 ? strtoul(argv[2], NULL, 10)
+				 : 8ul;
+	struct Record *records;
+	struct BHeap *serial, *parallel;
+	uint64_t start;
+	double serial_ns, parallel_ns;
+
+	HANDLE_MALLOC(records, sizeof(struct Record) * length);
+
+	seed_rng(42u);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		records[i].key = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+			       | pcg32_random_r(&_RNG);
+		records[i].id  = i;
+	}
+
+	start  = bench_now_ns();
+	serial = array_into_bheap(records, length, sizeof(struct Record),
+				  &compare_record);
+	serial_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	if (!is_heap(serial)) {
+		puts("FAILED: array_into_bheap output out of order");
+		return EXIT_FAILURE;
+	}
+
+	printf("array_into_bheap\t%zu records\t%8.2f ns/record\n\n"
+	       "threads\tns/record\tspeedup\n",
+	       length, serial_ns);
+
+	for (size_t count_threads = 1ul;
+	     count_threads <= max_threads;
+	     count_threads *= 2ul) {
+		start	 = bench_now_ns();
+		parallel = parray_into_dary_bheap(records, length,
+						  sizeof(struct Record),
+						  BHEAP_ARITY, count_threads,
+						  &compare_record);
+		parallel_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+		if (!is_heap(parallel)) {
+			puts("FAILED: parray_into_dary_bheap output out of "
+			     "order");
+			return EXIT_FAILURE;
+		}
+
+		if (memcmp(&parallel->nodes[parallel->width],
+			   &serial->nodes[serial->width],
+			   sizeof(struct Record) * length) != 0) {
+			puts("FAILED: parray_into_dary_bheap output differs "
+			     "from array_into_bheap");
+			return EXIT_FAILURE;
+		}
+
+		printf("%zu\t%9.2f\t%6.2fx\n",
+		       count_threads, parallel_ns, serial_ns / parallel_ns);
+
+		free_bheap(parallel);
+	}
+
+	free_bheap(serial);
+	free(records);
+
+	return 0;
+}
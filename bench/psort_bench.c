@@ -0,0 +1,86 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <psort/psort.h>
+#include <bench/bench.h>
+
+/*			- psort_bench.c -
+ * sorting 'length' 16-byte records: 'bheap_sort' vs 'bheap_psort_threads' at
+ * 1, 2, 4, ... up to 'max threads' threads, each run checked for order
+ *
+ * usage: psort_bench [length] [max threads]
+ */
+
+static void fill_records(struct Record *records,
+			 const size_t length)
+{
+	seed_rng(42u);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		records[i].key = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+			       | pcg32_random_r(&_RNG);
+		records[i].id  = i;
+	}
+}
+
+static bool is_sorted(const struct Record *records,
+		      const size_t length)
+{
+	for (size_t i = 1ul; i < length; ++i)
+		if (records[i].key < records[i - 1ul].key)
+			return false;
+
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 4000000ul;
+	const size_t max_threads = (argc > 2)
+				 ? strtoul(argv[2], NULL, 10)
+				 : 8ul;
+	struct Record *records;
+	uint64_t start;
+	double serial_ns, parallel_ns;
+
+	HANDLE_MALLOC(records, sizeof(struct Record) * length);
+
+	fill_records(records, length);
+	start = bench_now_ns();
+	bheap_sort(records, length, sizeof(struct Record), &compare_record);
+	serial_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	if (!is_sorted(records, length)) {
+		puts("FAILED: bheap_sort output out of order");
+		return EXIT_FAILURE;
+	}
+
+	printf("bheap_sort\t%zu records\t%8.2f ns/record\n\n"
+	       "threads\tns/record\tspeedup\n",
+	       length, serial_ns);
+
+	for (size_t count_threads = 1ul;
+	     count_threads <= max_threads;
+	     count_threads *= 2ul) {
+		fill_records(records, length);
+		start = bench_now_ns();
+		bheap_psort_threads(records, length, sizeof(struct Record),
+				    count_threads, &compare_record);
+		parallel_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+		if (!is_sorted(records, length)) {
+			puts("FAILED: bheap_psort_threads output out of order");
+			return EXIT_FAILURE;
+		}
+
+		printf("%zu\t%9.2f\t%6.2fx\n",
+		       count_threads, parallel_ns, serial_ns / parallel_ns);
+	}
+
+	free(records);
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <rheap/rheap.h>
+#include <bench/bench.h>
+#include <bench/graph.h>
+
+/*			- rheap_bench.c -
+ * Dijkstra on a random sparse graph, both with lazy duplicates (insert on
+ * every relaxation, skip stale entries on extract): 'struct BHeap' vs 'struct
+ * RHeap' keyed on the (monotone) tentative distance
+ *
+ * usage: rheap_bench [vertices] [degree]
+ */
+
+static size_t radix_dijkstra(const struct Graph *graph,
+			     uint64_t *distances)
+{
+	struct RHeap *heap = init_rheap(sizeof(struct Entry), sizeof(uint64_t));
+	struct Entry next = { 0lu, 0lu };
+	const struct Entry *root;
+	size_t peak = 0ul;
+
+	for (size_t v = 0ul; v < graph->count_vertices; ++v)
+		distances[v] = INFINITE_DISTANCE;
+
+	distances[0l] = 0lu;
+	rheap_insert(heap, &next);
+
+	while ((root = rheap_extract(heap)) != NULL) {
+		const uint64_t vertex	= root->vertex;
+		const uint64_t distance = root->distance;
+
+		/* stale duplicate */
+		if (distance > distances[vertex])
+			continue;
+
+		for (size_t e = graph->offsets[vertex];
+		     e < graph->offsets[vertex + 1ul]; ++e) {
+			next.distance = distance + graph->weights[e];
+			next.vertex   = graph->targets[e];
+
+			if (next.distance < distances[next.vertex]) {
+				distances[next.vertex] = next.distance;
+				rheap_insert(heap, &next);
+
+				if (heap->count > peak)
+					peak = heap->count;
+			}
+		}
+	}
+
+	free_rheap(heap);
+
+	return peak;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count_vertices = (argc > 1)
+				    ? strtoul(argv[1], NULL, 10)
+				    : 1000000ul;
+	const size_t degree = (argc > 2)
+			    ? strtoul(argv[2], NULL, 10)
+			    : 8ul;
+	struct Graph graph;
+	uint64_t *lazy_distances, *radix_distances;
+	uint64_t start;
+	double lazy_ms, radix_ms;
+	size_t lazy_peak, radix_peak;
+
+	seed_rng(42u);
+	init_graph(&graph, count_vertices, degree);
+
+	HANDLE_MALLOC(lazy_distances,  sizeof(uint64_t) * count_vertices);
+	HANDLE_MALLOC(radix_distances, sizeof(uint64_t) * count_vertices);
+
+	start	  = bench_now_ns();
+	lazy_peak = lazy_dijkstra(&graph, lazy_distances);
+	lazy_ms   = (bench_now_ns() - start) / 1e6;
+
+	start	   = bench_now_ns();
+	radix_peak = radix_dijkstra(&graph, radix_distances);
+	radix_ms   = (bench_now_ns() - start) / 1e6;
+
+	if (memcmp(lazy_distances, radix_distances,
+		   sizeof(uint64_t) * count_vertices) != 0) {
+		puts("FAILED: distances differ");
+		return EXIT_FAILURE;
+	}
+
+	printf("%zu vertices, %zu edges\n"
+	       "\t%-8s %12s %12s\n"
+	       "\t%-8s %12.2f %12zu\n"
+	       "\t%-8s %12.2f %12zu\n",
+	       count_vertices, count_vertices * degree,
+	       "heap", "ms", "peak count",
+	       "bheap", lazy_ms, lazy_peak,
+	       "rheap", radix_ms, radix_peak);
+
+	free(lazy_distances);
+	free(radix_distances);
+	free_graph(&graph);
+
+	return 0;
+}
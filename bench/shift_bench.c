@@ -0,0 +1,89 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- shift_bench.c -
+ * top-down vs bottom-up (Wegener) shift-down on string keys: comparisons and
+ * ns per extract and per sorted node
+ *
+ * usage: shift_bench [length]
+ */
+
+#define KEY_SIZE 32ul
+
+static unsigned long comparisons;
+
+static int compare_key(const void *x,
+		       const void *y)
+{
+	++comparisons;
+	return strcmp((const char *) x, (const char *) y) < 0;
+}
+
+static void shift_bench(const char *keys,
+			const size_t length,
+			const size_t arity,
+			const enum BHeapShiftMode shift_mode)
+{
+	struct BHeap *heap = init_sized_dary_bheap(KEY_SIZE, length, arity,
+						   &compare_key);
+	uint64_t start;
+	double extract_ns, extract_cmp, sort_ns, sort_cmp;
+
+	set_bheap_shift_mode(heap, shift_mode);
+	bheap_insert_array(heap, keys, length);
+
+	comparisons = 0ul;
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i)
+		(void) bheap_extract(heap);
+	extract_ns  = bench_ns_per_op(start, bench_now_ns(), length);
+	extract_cmp = ((double) comparisons) / length;
+
+	memcpy(&heap->nodes[KEY_SIZE], keys, KEY_SIZE * length);
+
+	comparisons = 0ul;
+	start = bench_now_ns();
+	do_bheap_sort(heap->nodes, length, KEY_SIZE, heap->log_arity,
+		      shift_mode, &compare_key);
+	sort_ns  = bench_ns_per_op(start, bench_now_ns(), length);
+	sort_cmp = ((double) comparisons) / length;
+
+	printf("%-9s\t%2zu\t%10zu\t%8.2f\t%8.2f\t%8.2f\t%8.2f\n",
+	       (shift_mode == BHEAP_SHIFT_BOTTOM_UP) ? "bottom-up" : "top-down",
+	       arity, length, extract_ns, extract_cmp, sort_ns, sort_cmp);
+
+	free_bheap(heap);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 1000000ul;
+	static const size_t arities[] = { 2ul, 4ul };
+	char *keys;
+
+	HANDLE_MALLOC(keys, KEY_SIZE * length);
+
+	seed_rng(42u);
+
+	/* long shared prefix makes every comparison pay for a full scan */
+	for (size_t i = 0ul; i < length; ++i)
+		snprintf(&keys[i * KEY_SIZE], KEY_SIZE,
+			 "tenant/0000/queue/%010u", pcg32_random_r(&_RNG));
+
+	puts("mode\t\tarity\tlength\t\textract ns\textract cmp\tsort ns"
+	     "\t\tsort cmp\t(per node)");
+
+	for (size_t a = 0ul; a < sizeof(arities) / sizeof(arities[0]); ++a) {
+		shift_bench(keys, length, arities[a], BHEAP_SHIFT_TOP_DOWN);
+		shift_bench(keys, length, arities[a], BHEAP_SHIFT_BOTTOM_UP);
+	}
+
+	free(keys);
+
+	return 0;
+}
@@ -0,0 +1,142 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- shrink_bench.c -
+ * bursty load (fill to 'peak' nodes, drain to 'peak / 1000', repeat) through
+ * a counting 'struct BHeapAllocator', with and without a shrink policy:
+ * time per operation, bytes held after each drain, peak bytes, and allocator
+ * calls
+ *
+ * usage: shrink_bench [peak] [bursts]
+ */
+
+struct Counter {
+	size_t live;		/* bytes currently handed out */
+	size_t peak;
+	size_t calls;
+};
+
+static void *counting_alloc(void *context,
+			    const size_t size)
+{
+	struct Counter *const counter = (struct Counter *) context;
+
+	counter->live += size;
+	++(counter->calls);
+
+	if (counter->live > counter->peak)
+		counter->peak = counter->live;
+
+	return malloc(size);
+}
+
+static void *counting_realloc(void *context,
+			      void *block,
+			      const size_t prev_size,
+			      const size_t size)
+{
+	struct Counter *const counter = (struct Counter *) context;
+
+	counter->live += size - prev_size;
+	++(counter->calls);
+
+	if (counter->live > counter->peak)
+		counter->peak = counter->live;
+
+	return realloc(block, size);
+}
+
+static void counting_free(void *context,
+			  void *block,
+			  const size_t size)
+{
+	struct Counter *const counter = (struct Counter *) context;
+
+	counter->live -= size;
+	++(counter->calls);
+
+	free(block);
+}
+
+static int compare_key(const void *x,
+		       const void *y)
+{
+	return *((const uint64_t *) x) < *((const uint64_t *) y);
+}
+
+static void run_bursts(const size_t peak,
+		       const size_t bursts,
+		       const unsigned int shrink_ratio)
+{
+	struct Counter counter = { 0ul, 0ul, 0ul };
+	const struct BHeapAllocator allocator = {
+		.alloc	 = &counting_alloc,
+		.realloc = &counting_realloc,
+		.free	 = &counting_free,
+		.context = &counter
+	};
+	struct BHeap *heap = init_allocated_dary_bheap(sizeof(uint64_t),
+						       BHEAP_DEFAULT_ALLOC,
+						       BHEAP_ARITY,
+						       &allocator,
+						       &compare_key);
+	size_t drained_bytes = 0ul;
+	uint64_t elapsed     = 0lu;
+	uint64_t start, key;
+
+	set_bheap_shrink_ratio(heap, shrink_ratio);
+	seed_rng(42u);
+
+	for (size_t b = 0ul; b < bursts; ++b) {
+		start = bench_now_ns();
+
+		while (heap->count < peak) {
+			key = pcg32_random_r(&_RNG);
+			bheap_insert(heap, &key);
+		}
+
+		while (heap->count > (peak / 1000ul))
+			(void) bheap_extract(heap);
+
+		elapsed += bench_now_ns() - start;
+
+		drained_bytes += bheap_resident_bytes(heap);
+
+		if (counter.live != bheap_resident_bytes(heap))
+			EXIT_ON_FAILURE("resident bytes disagree with "
+					"allocator");
+	}
+
+	printf("%u\t%12.2f\t%16zu\t%10zu\t%8zu\n",
+	       shrink_ratio,
+	       ((double) elapsed) / (bursts * 2ul * peak),
+	       drained_bytes / bursts,
+	       bheap_peak_bytes(heap),
+	       counter.calls);
+
+	free_bheap(heap);
+
+	if (counter.live != 0ul)
+		EXIT_ON_FAILURE("allocator bytes leaked");
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t peak = (argc > 1)
+			  ? strtoul(argv[1], NULL, 10)
+			  : 1000000ul;
+	const size_t bursts = (argc > 2)
+			    ? strtoul(argv[2], NULL, 10)
+			    : 10ul;
+
+	puts("shrink\tns/op (~)\tdrained bytes\tpeak bytes\tallocs");
+
+	run_bursts(peak, bursts, 0u);
+	run_bursts(peak, bursts, 4u);
+	run_bursts(peak, bursts, 8u);
+
+	return 0;
+}
@@ -0,0 +1,109 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>	/* open */
+#include <unistd.h>	/* close, unlink */
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- snapshot_bench.c -
+ * restoring a 'length'-node heap of 16-byte records after a restart: inserting
+ * every record again, bulk loading with 'bheap_insert_array', or mapping a
+ * snapshot written by 'bheap_save' with 'bheap_map' (plus the cost of the
+ * first extractions, which fault the touched pages in); checks that the mapped
+ * heap extracts in the same order as the original
+ *
+ * usage: snapshot_bench [length] [snapshot path]
+ */
+
+#define BENCH_EXTRACTIONS 1000ul
+
+static inline double elapsed_ms(const uint64_t start)
+{
+	return ((double) (bench_now_ns() - start)) / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 10000000ul;
+	const char *const path = (argc > 2)
+			       ? argv[2]
+			       : "/tmp/snapshot_bench.bheap";
+	struct Record *records;
+	struct BHeap *heap, *mapped;
+	const struct Record *x, *y;
+	uint64_t start;
+	bool ordered = true;
+	int fd;
+
+	HANDLE_MALLOC(records, sizeof(struct Record) * length);
+
+	seed_rng(42u);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		records[i].key = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+			       | pcg32_random_r(&_RNG);
+		records[i].id  = i;
+	}
+
+	printf("restoring %zu records (%zu MiB)\n",
+	       length, (length * sizeof(struct Record)) >> 20);
+
+	heap  = init_bheap(sizeof(struct Record), &compare_record);
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i)
+		bheap_insert(heap, &records[i]);
+	printf("\t%-20s %10.2f ms\n", "bheap_insert", elapsed_ms(start));
+	free_bheap(heap);
+
+	heap  = init_bheap(sizeof(struct Record), &compare_record);
+	start = bench_now_ns();
+	bheap_insert_array(heap, records, length);
+	printf("\t%-20s %10.2f ms\n", "bheap_insert_array", elapsed_ms(start));
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0)
+		EXIT_ON_FAILURE("failed to create '%s'", path);
+
+	start = bench_now_ns();
+	bheap_save(heap, fd);
+	printf("\t%-20s %10.2f ms\n", "bheap_save", elapsed_ms(start));
+
+	if (close(fd) != 0)
+		EXIT_ON_FAILURE("failed to close '%s'", path);
+
+	start  = bench_now_ns();
+	mapped = bheap_map(path, &compare_record);
+	printf("\t%-20s %10.2f ms\n", "bheap_map", elapsed_ms(start));
+
+	if (mapped == NULL)
+		EXIT_ON_FAILURE("failed to map '%s'", path);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; (i < BENCH_EXTRACTIONS) && (i < length); ++i)
+		(void) bheap_extract(mapped);
+	printf("\t%-20s %10.2f ms\n", "first extractions", elapsed_ms(start));
+
+	for (size_t i = 0ul; (i < BENCH_EXTRACTIONS) && (i < length); ++i)
+		(void) bheap_extract(heap);
+
+	while ((x = bheap_extract(heap)) != NULL) {
+		y	 = bheap_extract(mapped);
+		ordered &= (y != NULL) && (x->key == y->key);
+	}
+
+	if (!ordered || (mapped->count != 0ul)) {
+		(void) unlink(path);
+		EXIT_ON_FAILURE("mapped heap disagrees with original");
+	}
+
+	free_bheap(mapped);
+	free_bheap(heap);
+	free(records);
+
+	(void) unlink(path);
+
+	return 0;
+}
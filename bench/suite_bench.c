@@ -0,0 +1,233 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- suite_bench.c -
+ * regression suite for the core primitives: 'bheap_insert', 'bheap_extract',
+ * 'bheap_insert_array', 'bheap_sort' and 'shuffle_array', swept over node
+ * width, heap size and key distribution (a uint32_t key leads each node).
+ *
+ * Each cell repeats its operation until at least 'min ops' are timed and
+ * reports ns/op, comparisons/op and throughput (M ops/s, MB/s).  A table goes
+ * to stdout; with a path, the same rows are also written there as
+ * tab-separated values in a fixed order, so runs from two builds can be
+ * diffed or joined directly.  Every cell is seeded with seed_rng(42).
+ *
+ * usage: suite_bench [tsv path] [min ops]
+ */
+
+/* cells whose array would exceed this are skipped */
+#define SUITE_MAX_BYTES (64ul << 20)
+
+enum SuiteDist {
+	SUITE_UNIFORM,
+	SUITE_ASCENDING,
+	SUITE_DESCENDING,
+	SUITE_FEW_UNIQUE,	/* 16 distinct keys */
+	SUITE_COUNT_DIST
+};
+
+enum SuiteOp {
+	SUITE_INSERT,
+	SUITE_EXTRACT,
+	SUITE_INSERT_ARRAY,
+	SUITE_SORT,
+	SUITE_SHUFFLE,
+	SUITE_COUNT_OP
+};
+
+static const char *const dist_names[SUITE_COUNT_DIST] = {
+	"uniform", "ascending", "descending", "few_unique"
+};
+
+static const char *const op_names[SUITE_COUNT_OP] = {
+	"insert", "extract", "insert_array", "sort", "shuffle"
+};
+
+static const size_t widths[] = { 4ul, 8ul, 16ul, 64ul, 256ul };
+static const size_t sizes[]  = { 1ul << 10, 1ul << 16, 1ul << 20 };
+
+static size_t count_compare;
+
+static int compare_key(const void *x,
+		       const void *y)
+{
+	++count_compare;
+
+	return *((const uint32_t *) x) < *((const uint32_t *) y);
+}
+
+static void fill_nodes(char *const nodes,
+		       const size_t length,
+		       const size_t width,
+		       const enum SuiteDist dist)
+{
+	uint32_t key;
+
+	memset(nodes, 0, length * width);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		switch (dist) {
+		case SUITE_ASCENDING:
+			key = (uint32_t) i;
+			break;
+		case SUITE_DESCENDING:
+			key = (uint32_t) (length - i);
+			break;
+		case SUITE_FEW_UNIQUE:
+			key = pcg32_random_r(&_RNG) & 15u;
+			break;
+		default:
+			key = pcg32_random_r(&_RNG);
+		}
+
+		memcpy(&nodes[i * width], &key, sizeof(key));
+	}
+}
+
+/* returns elapsed ns over 'reps' repetitions, adding comparisons made inside
+ * the timed regions to '*compares' */
+static uint64_t time_op(const enum SuiteOp op,
+			struct BHeap *heap,
+			const char *const array,
+			char *const scratch,
+			const size_t length,
+			const size_t reps,
+			size_t *const compares)
+{
+	const size_t width = heap->width;
+	uint64_t elapsed   = 0lu;
+	uint64_t start;
+	size_t counted;
+
+	*compares = 0ul;
+
+	for (size_t r = 0ul; r < reps; ++r) {
+		clear_bheap(heap);
+
+		if (op == SUITE_EXTRACT)
+			bheap_insert_array(heap, array, length);
+		else if ((op == SUITE_SORT) || (op == SUITE_SHUFFLE))
+			memcpy(scratch, array, length * width);
+
+		counted = count_compare;
+		start	= bench_now_ns();
+
+		switch (op) {
+		case SUITE_INSERT:
+			for (size_t i = 0ul; i < length; ++i)
+				bheap_insert(heap, &array[i * width]);
+			break;
+		case SUITE_EXTRACT:
+			while (bheap_extract(heap) != NULL)
+				;
+			break;
+		case SUITE_INSERT_ARRAY:
+			bheap_insert_array(heap, array, length);
+			break;
+		case SUITE_SORT:
+			bheap_sort(scratch, length, width, &compare_key);
+			break;
+		default:
+			shuffle_array(scratch, length, width);
+		}
+
+		elapsed	  += bench_now_ns() - start;
+		*compares += count_compare - counted;
+	}
+
+	return elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *tsv = NULL;
+	const size_t min_ops = (argc > 2)
+			     ? strtoul(argv[2], NULL, 10)
+			     : (1ul << 21);
+	const size_t count_widths = sizeof(widths) / sizeof(widths[0]);
+	const size_t count_sizes  = sizeof(sizes) / sizeof(sizes[0]);
+	char *array, *scratch;
+	struct BHeap *heap;
+	size_t width, length, reps, compares;
+	double ns_op, cmp_op;
+	uint64_t elapsed;
+
+	if (argc > 1) {
+		tsv = fopen(argv[1], "w");
+
+		if (tsv == NULL)
+			EXIT_ON_FAILURE("failed to open '%s'", argv[1]);
+
+		fputs("op\twidth\tsize\tdist\tns_op\tcmp_op\tmops_s\tmb_s\n",
+		      tsv);
+	}
+
+	HANDLE_MALLOC(array, SUITE_MAX_BYTES);
+	HANDLE_MALLOC(scratch, SUITE_MAX_BYTES);
+
+	printf("%-13s %6s %8s %-11s %10s %10s %10s %10s\n",
+	       "op", "width", "size", "dist",
+	       "ns/op", "cmp/op", "Mops/s", "MB/s");
+
+	for (size_t w = 0ul; w < count_widths; ++w) {
+		width = widths[w];
+
+		for (size_t s = 0ul; s < count_sizes; ++s) {
+			length = sizes[s];
+
+			if ((width * length) > SUITE_MAX_BYTES)
+				continue;
+
+			reps = (min_ops + length - 1ul) / length;
+			heap = init_sized_bheap(width, length, &compare_key);
+
+			for (int d = 0; d < SUITE_COUNT_DIST; ++d) {
+				for (int o = 0; o < SUITE_COUNT_OP; ++o) {
+					seed_rng(42u);
+					fill_nodes(array, length, width,
+						   (enum SuiteDist) d);
+
+					elapsed = time_op((enum SuiteOp) o,
+							  heap, array, scratch,
+							  length, reps,
+							  &compares);
+
+					ns_op  = ((double) elapsed)
+					       / (length * reps);
+					cmp_op = ((double) compares)
+					       / (length * reps);
+
+					printf("%-13s %6zu %8zu %-11s "
+					       "%10.2f %10.2f %10.2f %10.2f\n",
+					       op_names[o], width, length,
+					       dist_names[d], ns_op, cmp_op,
+					       1e3 / ns_op, (1e3 * width) / ns_op);
+
+					if (tsv != NULL)
+						fprintf(tsv,
+							"%s\t%zu\t%zu\t%s\t"
+							"%.3f\t%.3f\t%.3f\t%.3f\n",
+							op_names[o], width,
+							length, dist_names[d],
+							ns_op, cmp_op,
+							1e3 / ns_op,
+							(1e3 * width) / ns_op);
+				}
+			}
+
+			free_bheap(heap);
+		}
+	}
+
+	free(scratch);
+	free(array);
+
+	if ((tsv != NULL) && (fclose(tsv) != 0))
+		EXIT_ON_FAILURE("failed to write '%s'", argv[1]);
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <bench/bench.h>
+
+/*			- topk_bench.c -
+ * keeping the greatest 'k' of a stream of 'length' random 64-bit keys: a
+ * fixed-capacity top-K heap ('bheap_topk_insert') vs inserting every key and
+ * extracting the root whenever the heap exceeds 'k' nodes, with comparisons
+ * per key and a check that both keep the same keys
+ *
+ * usage: topk_bench [length] [k ...]
+ */
+
+static size_t count_compare;
+
+static int compare_key(const void *x,
+		       const void *y)
+{
+	++count_compare;
+
+	return *((const uint64_t *) x) < *((const uint64_t *) y);
+}
+
+static inline uint64_t next_key(void)
+{
+	return (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+	     | pcg32_random_r(&_RNG);
+}
+
+static void run_topk(const size_t length,
+		     const size_t k,
+		     uint64_t *const topk,
+		     uint64_t *const naive)
+{
+	struct BHeap *heap;
+	uint64_t start, key;
+	double topk_ns, naive_ns, topk_cmp, naive_cmp;
+
+	seed_rng(42u);
+	count_compare = 0ul;
+	heap	      = init_topk_bheap(sizeof(uint64_t), k, &compare_key);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		key = next_key();
+		(void) bheap_topk_insert(heap, &key);
+	}
+	topk_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	topk_cmp = ((double) count_compare) / length;
+	(void) bheap_topk_sorted(heap, topk);
+	free_bheap(heap);
+
+	seed_rng(42u);
+	count_compare = 0ul;
+	heap	      = init_bheap(sizeof(uint64_t), &compare_key);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		key = next_key();
+		bheap_insert(heap, &key);
+
+		if (heap->count > k)
+			(void) bheap_extract(heap);
+	}
+	naive_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	naive_cmp = ((double) count_compare) / length;
+	(void) bheap_extract_n(heap, naive, k);
+	free_bheap(heap);
+
+	/* 'naive' is in extraction order, 'topk' in reverse */
+	for (size_t i = 0ul, j = k - 1ul; i < k; ++i, --j)
+		if (topk[i] != naive[j])
+			EXIT_ON_FAILURE("top-K heaps disagree at k = %zu", k);
+
+	printf("\t%8zu %12.2f %12.2f %12.2f %12.2f\n",
+	       k, topk_ns, topk_cmp, naive_ns, naive_cmp);
+}
+
+int main(int argc, char *argv[])
+{
+	static const size_t default_k[] = { 10ul, 100ul, 1000ul, 100000ul };
+	const size_t length = (argc > 1)
+			    ? strtoul(argv[1], NULL, 10)
+			    : 10000000ul;
+	size_t k, max_k = 0ul;
+	uint64_t *topk, *naive;
+	const size_t count_k = (argc > 2)
+			     ? (size_t) (argc - 2)
+			     : (sizeof(default_k) / sizeof(default_k[0]));
+
+	for (size_t i = 0ul; i < count_k; ++i) {
+		k = (argc > 2) ? strtoul(argv[i + 2ul], NULL, 10) : default_k[i];
+
+		if (k > max_k)
+			max_k = k;
+	}
+
+	HANDLE_MALLOC(topk, sizeof(uint64_t) * max_k);
+	HANDLE_MALLOC(naive, sizeof(uint64_t) * max_k);
+
+	printf("greatest k of %zu keys\n"
+	       "\t%8s %12s %12s %12s %12s\n",
+	       length, "k", "topk ns", "topk cmp", "naive ns", "naive cmp");
+
+	for (size_t i = 0ul; i < count_k; ++i) {
+		k = (argc > 2) ? strtoul(argv[i + 2ul], NULL, 10) : default_k[i];
+
+		if ((k == 0ul) || (k > length))
+			continue;
+
+		run_topk(length, k, topk, naive);
+	}
+
+	free(naive);
+	free(topk);
+
+	return 0;
+}
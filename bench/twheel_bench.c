@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <twheel/twheel.h>
+#include <bench/bench.h>
+
+/*			- twheel_bench.c -
+ * 'count' timers under churn, as a connection table sees them: each tick,
+ * 'churn' random timers are reset to a new deadline ('twheel_rearm') and
+ * every timer that fires is re-armed.  Deadlines are mostly near (up to
+ * 'span' ticks) with 1% far (up to 2^30 ticks).  'struct TWheel' vs a
+ * 'struct BHeap' of (deadline, id, generation) that cancels lazily, skipping
+ * stale nodes as they surface.
+ *
+ * usage: twheel_bench [count] [ticks] [churn] [span]
+ */
+
+struct Timer {
+	uint64_t deadline;
+	uint64_t id;
+	uint64_t generation;
+};
+
+struct Churn {
+	size_t span;
+	size_t fired;
+	uint64_t now;
+	struct TWheel *wheel;
+	size_t *handles;
+};
+
+static int compare_timer(const void *x,
+			 const void *y)
+{
+	return ((const struct Timer *) x)->deadline
+	     < ((const struct Timer *) y)->deadline;
+}
+
+static inline uint64_t next_deadline(const uint64_t now,
+				     const size_t span)
+{
+	if (pcg32_random_r(&_RNG) % 100u == 0u)
+		return now + 1lu + (pcg32_random_r(&_RNG) & ((1u << 30) - 1u));
+
+	return now + 1lu + (pcg32_random_r(&_RNG) % span);
+}
+
+static void rearm(void *context,
+		  const size_t handle,
+		  void *data)
+{
+	struct Churn *const churn = (struct Churn *) context;
+	const size_t id		  = (size_t) data;
+
+	(void) handle;
+
+	++(churn->fired);
+	churn->handles[id] = twheel_arm(churn->wheel,
+					next_deadline(churn->now, churn->span),
+					data);
+}
+
+static void run_twheel(const size_t count,
+		       const size_t ticks,
+		       const size_t churn_per_tick,
+		       const size_t span)
+{
+	struct Churn churn = { .span = span, .fired = 0ul, .now = 0lu };
+	uint64_t start, arm_ns, churn_ns;
+	size_t id;
+
+	HANDLE_MALLOC(churn.handles, sizeof(size_t) * count);
+
+	seed_rng(42u);
+	churn.wheel = init_twheel(0lu);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < count; ++i)
+		churn.handles[i] = twheel_arm(churn.wheel,
+					      next_deadline(0lu, span),
+					      (void *) i);
+	arm_ns = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (size_t t = 1ul; t <= ticks; ++t) {
+		for (size_t c = 0ul; c < churn_per_tick; ++c) {
+			id = pcg32_random_r(&_RNG) % count;
+			churn.handles[id] = twheel_rearm(churn.wheel,
+							 churn.handles[id],
+							 next_deadline(churn.now,
+								       span));
+		}
+
+		churn.now = t;
+		(void) twheel_advance(churn.wheel, t, &rearm, &churn);
+	}
+	churn_ns = bench_now_ns() - start;
+
+	printf("\t%-8s %12.2f %12.2f %12zu %12zu\n",
+	       "twheel",
+	       ((double) arm_ns) / count,
+	       ((double) churn_ns) / ((ticks * churn_per_tick) + churn.fired),
+	       churn.fired,
+	       churn.wheel->count);
+
+	free_twheel(churn.wheel);
+	free(churn.handles);
+}
+
+static void run_bheap(const size_t count,
+		      const size_t ticks,
+		      const size_t churn_per_tick,
+		      const size_t span)
+{
+	struct BHeap *heap = init_bheap(sizeof(struct Timer), &compare_timer);
+	uint64_t *generations;
+	uint64_t start, arm_ns, churn_ns;
+	size_t fired = 0ul;
+	struct Timer next;
+	const struct Timer *root;
+
+	HANDLE_CALLOC(generations, count, sizeof(uint64_t));
+
+	seed_rng(42u);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < count; ++i) {
+		next.deadline	= next_deadline(0lu, span);
+		next.id		= i;
+		next.generation = 0lu;
+		bheap_insert(heap, &next);
+	}
+	arm_ns = bench_now_ns() - start;
+
+	start = bench_now_ns();
+	for (size_t t = 1ul; t <= ticks; ++t) {
+		for (size_t c = 0ul; c < churn_per_tick; ++c) {
+			next.id		= pcg32_random_r(&_RNG) % count;
+			next.generation = ++generations[next.id];
+			next.deadline	= next_deadline(t - 1lu, span);
+			bheap_insert(heap, &next);
+		}
+
+		while ((heap->count > 0ul)
+		       && ((root = (const struct Timer *)
+			    &heap->nodes[heap->width])->deadline <= t)) {
+			next = *root;
+			(void) bheap_extract(heap);
+
+			if (next.generation != generations[next.id])
+				continue;
+
+			++fired;
+			next.deadline	= next_deadline(t, span);
+			next.generation = ++generations[next.id];
+			bheap_insert(heap, &next);
+		}
+	}
+	churn_ns = bench_now_ns() - start;
+
+	printf("\t%-8s %12.2f %12.2f %12zu %12zu\n",
+	       "bheap",
+	       ((double) arm_ns) / count,
+	       ((double) churn_ns) / ((ticks * churn_per_tick) + fired),
+	       fired,
+	       heap->count);
+
+	free(generations);
+	free_bheap(heap);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t count = (argc > 1)
+			   ? strtoul(argv[1], NULL, 10)
+			   : 1000000ul;
+	const size_t ticks = (argc > 2)
+			   ? strtoul(argv[2], NULL, 10)
+			   : 10000ul;
+	const size_t churn = (argc > 3)
+			   ? strtoul(argv[3], NULL, 10)
+			   : 200ul;
+	const size_t span = (argc > 4)
+			  ? strtoul(argv[4], NULL, 10)
+			  : 100000ul;
+
+	printf("%zu timers over %zu ticks, %zu resets per tick, near span %zu\n"
+	       "\t%-8s %12s %12s %12s %12s\n",
+	       count, ticks, churn, span,
+	       "queue", "arm ns", "churn ns/op", "fired", "final nodes");
+
+	run_twheel(count, ticks, churn, span);
+	run_bheap(count, ticks, churn, span);
+
+	return 0;
+}
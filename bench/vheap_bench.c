@@ -0,0 +1,199 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <vheap/vheap.h>
+#include <bench/bench.h>
+
+/*			- vheap_bench.c -
+ * inserting then extracting 'length' random keys of each primitive type:
+ * 'struct BHeap' through a 'compare' callback vs 'struct VHeap' with each
+ * child selection kernel the CPU supports, all at one cache line of siblings
+ * per node (arity 16 for 4-byte keys, 8 for 8-byte keys)
+ *
+ * usage: vheap_bench [max length] (lengths 10^6, 10^7, ... up to it, e.g.
+ *	  100000000)
+ */
+
+static const char *const key_names[] = {
+	[VHEAP_KEY_U32]	   = "uint32_t",
+	[VHEAP_KEY_U64]	   = "uint64_t",
+	[VHEAP_KEY_FLOAT]  = "float",
+	[VHEAP_KEY_DOUBLE] = "double"
+};
+
+static int compare_u32(const void *x, const void *y)
+{
+	return *((const uint32_t *) x) < *((const uint32_t *) y);
+}
+
+static int compare_u64(const void *x, const void *y)
+{
+	return *((const uint64_t *) x) < *((const uint64_t *) y);
+}
+
+static int compare_float(const void *x, const void *y)
+{
+	return *((const float *) x) < *((const float *) y);
+}
+
+static int compare_double(const void *x, const void *y)
+{
+	return *((const double *) x) < *((const double *) y);
+}
+
+static int (*const compares[])(const void *,
+			       const void *) = {
+	[VHEAP_KEY_U32]	   = &compare_u32,
+	[VHEAP_KEY_U64]	   = &compare_u64,
+	[VHEAP_KEY_FLOAT]  = &compare_float,
+	[VHEAP_KEY_DOUBLE] = &compare_double
+};
+
+static void fill_keys(char *keys,
+		      const enum VHeapKey key,
+		      const size_t length)
+{
+	uint64_t rand;
+
+	seed_rng(42u);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		rand = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+		     | pcg32_random_r(&_RNG);
+
+		switch (key) {
+		case VHEAP_KEY_U32:
+			((uint32_t *) keys)[i] = (uint32_t) rand;
+			break;
+		case VHEAP_KEY_U64:
+			((uint64_t *) keys)[i] = rand;
+			break;
+		case VHEAP_KEY_FLOAT:
+			((float *) keys)[i] = (float) (rand >> 40);
+			break;
+		default:
+			((double *) keys)[i] = (double) (rand >> 11);
+		}
+	}
+}
+
+/* sums the extracted keys' bytes so every variant must agree */
+static uint64_t fold(const char *key,
+		     const size_t width,
+		     uint64_t checksum)
+{
+	for (size_t i = 0ul; i < width; ++i)
+		checksum = (checksum * 31lu) + (unsigned char) key[i];
+
+	return checksum;
+}
+
+static double run_bheap(const char *keys,
+			const enum VHeapKey key,
+			const size_t length,
+			uint64_t *checksum)
+{
+	const size_t width = vheap_key_width(key);
+	struct BHeap *heap = init_sized_dary_bheap(width, length,
+						   BHEAP_CACHE_LINE / width,
+						   compares[key]);
+	const uint64_t start = bench_now_ns();
+
+	for (size_t i = 0ul; i < length; ++i)
+		bheap_insert(heap, &keys[i * width]);
+
+	for (size_t i = 0ul; i < length; ++i)
+		*checksum = fold(bheap_extract(heap), width, *checksum);
+
+	const uint64_t stop = bench_now_ns();
+
+	free_bheap(heap);
+
+	return bench_ns_per_op(start, stop, length);
+}
+
+static double run_vheap(const char *keys,
+			const enum VHeapKey key,
+			const enum VHeapISA isa,
+			const size_t length,
+			uint64_t *checksum)
+{
+	const size_t width = vheap_key_width(key);
+	struct VHeap *heap = init_sized_dary_vheap(key, length,
+						   BHEAP_CACHE_LINE / width,
+						   isa);
+	char out[sizeof(uint64_t)];
+	const uint64_t start = bench_now_ns();
+
+	for (size_t i = 0ul; i < length; ++i)
+		vheap_insert(heap, &keys[i * width]);
+
+	for (size_t i = 0ul; i < length; ++i) {
+		(void) vheap_extract(heap, &out[0l]);
+		*checksum = fold(&out[0l], width, *checksum);
+	}
+
+	const uint64_t stop = bench_now_ns();
+
+	free_vheap(heap);
+
+	return bench_ns_per_op(start, stop, length);
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t max_length = (argc > 1)
+				? strtoul(argv[1], NULL, 10)
+				: 1000000ul;
+	uint64_t bheap_checksum, vheap_checksum;
+	double bheap_ns, vheap_ns[VHEAP_ISA_AVX2 + 1];
+	enum VHeapISA best;
+	char *keys;
+
+	HANDLE_MALLOC(keys, sizeof(uint64_t) * max_length);
+
+	puts("key\t\tlength\t\tcompare ns\tscalar ns\tsse4 ns"
+	     "\t\tavx2 ns\t\t(per node)");
+
+	for (size_t length = 1000000ul;
+	     length <= max_length;
+	     length *= 10ul) {
+		for (enum VHeapKey key = VHEAP_KEY_U32;
+		     key <= VHEAP_KEY_DOUBLE;
+		     ++key) {
+			fill_keys(keys, key, length);
+
+			bheap_checksum = 0lu;
+			bheap_ns = run_bheap(keys, key, length,
+					     &bheap_checksum);
+
+			best = vheap_best_isa(key);
+
+			printf("%-8s\t%10zu\t%10.2f", key_names[key], length,
+			       bheap_ns);
+
+			for (enum VHeapISA isa = VHEAP_ISA_SCALAR;
+			     isa <= best;
+			     ++isa) {
+				vheap_checksum = 0lu;
+				vheap_ns[isa] = run_vheap(keys, key, isa,
+							  length,
+							  &vheap_checksum);
+
+				if (vheap_checksum != bheap_checksum) {
+					puts("\nFAILED: checksum mismatch");
+					return EXIT_FAILURE;
+				}
+
+				printf("\t%9.2f", vheap_ns[isa]);
+			}
+
+			printf("\t%5.2fx\n", bheap_ns / vheap_ns[best]);
+		}
+	}
+
+	free(keys);
+
+	return 0;
+}
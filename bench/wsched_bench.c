@@ -0,0 +1,424 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <sched.h>		/* sched_yield */
+#include <time.h>		/* nanosleep */
+#include <unistd.h>		/* sysconf */
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <wsched/wsched.h>
+#include <bench/bench.h>
+
+/*			- wsched_bench.c -
+ * work-stealing 'struct WSched' vs one global 'struct BHeap' of tasks behind
+ * one mutex, both with the same submit / wait semantics (a worker waiting on
+ * a group runs queued tasks meanwhile), for 1, 2, 4, ... threads:
+ * 1. fork/join: a binary tree of tasks 'depth' levels deep, each inner task
+ *    submitting its two children to its own group and waiting on it, each
+ *    leaf spinning 'leaf spins' iterations
+ * 2. priority: 'HIGH_TASKS' high-priority tasks injected from outside every
+ *    'HIGH_INTERVAL_NS' while the workers chew through long low-priority
+ *    tasks, reporting mean and max latency from submission to start
+ *
+ * usage: wsched_bench [max threads] [depth] [leaf spins]
+ */
+
+#define HIGH_TASKS	 200ul
+#define HIGH_INTERVAL_NS 50000l
+#define LOW_PER_THREAD	 64ul
+#define LOW_SPINS	 100000ul
+
+static void spin(const size_t spins)
+{
+	volatile size_t sink = 0ul;
+
+	for (size_t i = 0ul; i < spins; ++i)
+		sink += i;
+}
+
+
+/* one global heap behind one mutex
+ ******************************************************************************/
+struct Global {
+	pthread_mutex_t lock;
+	pthread_cond_t wake;	/* tasks queued or 'stop' */
+	pthread_cond_t done;	/* some group's 'pending' reached 0 */
+	struct BHeap *tasks;
+	bool stop;
+	size_t count_threads;
+	pthread_t *threads;
+};
+
+static __thread bool on_global_worker;
+
+static int compare_task(const void *x,
+			const void *y)
+{
+	return ((const struct WSchedTask *) x)->priority
+	     > ((const struct WSchedTask *) y)->priority;
+}
+
+static void global_run(struct Global *global,
+		       const struct WSchedTask *const task)
+{
+	task->run(task->arg);
+
+	pthread_mutex_lock(&global->lock);
+	if ((task->group != NULL) && (--(task->group->pending) == 0ul))
+		pthread_cond_broadcast(&global->done);
+	pthread_mutex_unlock(&global->lock);
+}
+
+static void *global_work(void *arg)
+{
+	struct Global *const global = (struct Global *) arg;
+	struct WSchedTask task;
+
+	on_global_worker = true;
+
+	pthread_mutex_lock(&global->lock);
+	while (1) {
+		while (!global->stop && (global->tasks->count == 0ul))
+			pthread_cond_wait(&global->wake, &global->lock);
+
+		if (global->tasks->count == 0ul)
+			break;
+
+		memcpy(&task, bheap_extract(global->tasks), sizeof(task));
+		pthread_mutex_unlock(&global->lock);
+
+		global_run(global, &task);
+
+		pthread_mutex_lock(&global->lock);
+	}
+	pthread_mutex_unlock(&global->lock);
+
+	return NULL;
+}
+
+static struct Global *init_global(const size_t count_threads)
+{
+	struct Global *global;
+
+	HANDLE_MALLOC(global, sizeof(struct Global));
+	HANDLE_MALLOC(global->threads, sizeof(pthread_t) * count_threads);
+
+	pthread_mutex_init(&global->lock, NULL);
+	pthread_cond_init(&global->wake, NULL);
+	pthread_cond_init(&global->done, NULL);
+
+	global->tasks	      = init_bheap(sizeof(struct WSchedTask),
+					   &compare_task);
+	global->stop	      = false;
+	global->count_threads = count_threads;
+
+	for (size_t i = 0ul; i < count_threads; ++i)
+		if (pthread_create(&global->threads[i], NULL, &global_work,
+				   global) != 0)
+			EXIT_ON_FAILURE("failed to create thread %lu", i);
+
+	return global;
+}
+
+static void free_global(struct Global *global)
+{
+	pthread_mutex_lock(&global->lock);
+	global->stop = true;
+	pthread_cond_broadcast(&global->wake);
+	pthread_mutex_unlock(&global->lock);
+
+	for (size_t i = 0ul; i < global->count_threads; ++i)
+		pthread_join(global->threads[i], NULL);
+
+	free_bheap(global->tasks);
+	pthread_cond_destroy(&global->done);
+	pthread_cond_destroy(&global->wake);
+	pthread_mutex_destroy(&global->lock);
+	free(global->threads);
+	free(global);
+}
+
+static void global_submit(void *pool,
+			  struct WSchedGroup *group,
+			  const int64_t priority,
+			  WSchedRun run,
+			  void *arg)
+{
+	struct Global *const global = (struct Global *) pool;
+	const struct WSchedTask task = {
+		.priority = priority,
+		.run	  = run,
+		.arg	  = arg,
+		.group	  = group
+	};
+
+	pthread_mutex_lock(&global->lock);
+	if (group != NULL)
+		++(group->pending);
+	bheap_insert(global->tasks, &task);
+	pthread_cond_signal(&global->wake);
+	pthread_mutex_unlock(&global->lock);
+}
+
+static void global_wait(void *pool,
+			struct WSchedGroup *group)
+{
+	struct Global *const global = (struct Global *) pool;
+	struct WSchedTask task;
+
+	pthread_mutex_lock(&global->lock);
+
+	while (group->pending > 0ul) {
+		if (!on_global_worker) {
+			pthread_cond_wait(&global->done, &global->lock);
+			continue;
+		}
+
+		/* on a worker: help, as 'wsched_wait' does */
+		if (global->tasks->count > 0ul) {
+			memcpy(&task, bheap_extract(global->tasks),
+			       sizeof(task));
+			pthread_mutex_unlock(&global->lock);
+			global_run(global, &task);
+		} else {
+			pthread_mutex_unlock(&global->lock);
+			sched_yield();
+		}
+
+		pthread_mutex_lock(&global->lock);
+	}
+
+	pthread_mutex_unlock(&global->lock);
+}
+
+
+/* pool under test
+ ******************************************************************************/
+enum Kind {
+	KIND_WSCHED,
+	KIND_GLOBAL,
+	KIND_COUNT
+};
+
+static const char *const kind_names[KIND_COUNT] = { "wsched", "global" };
+
+static struct {
+	void *impl;
+	void (*submit)(void *,
+		       struct WSchedGroup *,
+		       const int64_t,
+		       WSchedRun,
+		       void *);
+	void (*wait)(void *,
+		     struct WSchedGroup *);
+} pool;
+
+static void wsched_submit_any(void *impl,
+			      struct WSchedGroup *group,
+			      const int64_t priority,
+			      WSchedRun run,
+			      void *arg)
+{
+	wsched_submit((struct WSched *) impl, group, priority, run, arg);
+}
+
+static void wsched_wait_any(void *impl,
+			    struct WSchedGroup *group)
+{
+	wsched_wait((struct WSched *) impl, group);
+}
+
+static void open_pool(const enum Kind kind,
+		      const size_t count_threads)
+{
+	if (kind == KIND_WSCHED) {
+		pool.impl   = init_wsched(count_threads);
+		pool.submit = &wsched_submit_any;
+		pool.wait   = &wsched_wait_any;
+	} else {
+		pool.impl   = init_global(count_threads);
+		pool.submit = &global_submit;
+		pool.wait   = &global_wait;
+	}
+}
+
+/* prints steals per 1000 tasks run for 'struct WSched' */
+static void close_pool(const enum Kind kind)
+{
+	struct WSched *sched;
+	size_t executed = 0ul;
+	size_t steals	= 0ul;
+
+	if (kind == KIND_GLOBAL) {
+		free_global((struct Global *) pool.impl);
+		printf(" %9s\n", "-");
+		return;
+	}
+
+	sched = (struct WSched *) pool.impl;
+
+	/* counted before each task finished, so visible once 'wait' returned */
+	for (size_t i = 0ul; i < sched->count_workers; ++i) {
+		executed += sched->workers[i].executed;
+		steals	 += sched->workers[i].steals;
+	}
+
+	free_wsched(sched);
+
+	printf(" %9.2f\n", (executed == 0ul)
+			   ? 0.0
+			   : (1000.0 * steals) / executed);
+}
+
+
+/* 1. fork/join
+ ******************************************************************************/
+static size_t leaf_spins;
+
+struct Fork {
+	unsigned int depth;
+};
+
+static void run_fork(void *arg)
+{
+	const struct Fork *const fork = (const struct Fork *) arg;
+	struct WSchedGroup group;
+	struct Fork children;
+
+	if (fork->depth == 0u) {
+		spin(leaf_spins);
+		return;
+	}
+
+	/* both children are identical, so they share one argument */
+	children.depth = fork->depth - 1u;
+
+	init_wsched_group(&group);
+	pool.submit(pool.impl, &group, (int64_t) children.depth, &run_fork,
+		    &children);
+	pool.submit(pool.impl, &group, (int64_t) children.depth, &run_fork,
+		    &children);
+	pool.wait(pool.impl, &group);
+}
+
+static void bench_fork(const enum Kind kind,
+		       const size_t count_threads,
+		       const unsigned int depth)
+{
+	const size_t count_tasks = (2ul << depth) - 1ul;
+	struct WSchedGroup group;
+	struct Fork root = { .depth = depth };
+	uint64_t start, elapsed;
+
+	open_pool(kind, count_threads);
+
+	init_wsched_group(&group);
+
+	start = bench_now_ns();
+	pool.submit(pool.impl, &group, (int64_t) depth, &run_fork, &root);
+	pool.wait(pool.impl, &group);
+	elapsed = bench_now_ns() - start;
+
+	printf("%-7s %7zu %12.3f %12.2f", kind_names[kind], count_threads,
+	       elapsed / 1e6, ((double) elapsed) / count_tasks);
+
+	close_pool(kind);
+}
+
+
+/* 2. priority
+ ******************************************************************************/
+struct Latency {
+	uint64_t submitted;
+	uint64_t started;
+};
+
+static void run_low(void *arg)
+{
+	(void) arg;
+
+	spin(LOW_SPINS);
+}
+
+static void run_high(void *arg)
+{
+	((struct Latency *) arg)->started = bench_now_ns();
+}
+
+static void bench_priority(const enum Kind kind,
+			   const size_t count_threads)
+{
+	const struct timespec interval = {
+		.tv_sec	 = 0,
+		.tv_nsec = HIGH_INTERVAL_NS
+	};
+	struct Latency latencies[HIGH_TASKS];
+	struct WSchedGroup group;
+	uint64_t latency, total = 0lu, max = 0lu;
+
+	open_pool(kind, count_threads);
+
+	init_wsched_group(&group);
+
+	for (size_t i = 0ul; i < (LOW_PER_THREAD * count_threads); ++i)
+		pool.submit(pool.impl, &group, 0l, &run_low, NULL);
+
+	for (size_t i = 0ul; i < HIGH_TASKS; ++i) {
+		(void) nanosleep(&interval, NULL);
+
+		latencies[i].submitted = bench_now_ns();
+		pool.submit(pool.impl, &group, 1l, &run_high, &latencies[i]);
+	}
+
+	pool.wait(pool.impl, &group);
+
+	for (size_t i = 0ul; i < HIGH_TASKS; ++i) {
+		latency = latencies[i].started - latencies[i].submitted;
+		total  += latency;
+
+		if (latency > max)
+			max = latency;
+	}
+
+	printf("%-7s %7zu %12.2f %12.2f", kind_names[kind], count_threads,
+	       (((double) total) / HIGH_TASKS) / 1e3, max / 1e3);
+
+	close_pool(kind);
+}
+
+
+int main(int argc, char *argv[])
+{
+	const long online  = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t max_threads = (online > 0l) ? ((size_t) online) : 1ul;
+	unsigned int depth = 16u;
+
+	leaf_spins = 2000ul;
+
+	if (argc > 1)
+		max_threads = strtoul(argv[1], NULL, 10);
+	if (argc > 2)
+		depth = (unsigned int) strtoul(argv[2], NULL, 10);
+	if (argc > 3)
+		leaf_spins = strtoul(argv[3], NULL, 10);
+
+	printf("fork/join: depth %u (%lu tasks), %zu leaf spins\n",
+	       depth, (2ul << depth) - 1ul, leaf_spins);
+	printf("%-7s %7s %12s %12s %9s\n",
+	       "pool", "threads", "ms", "ns/task", "steals/1k");
+
+	for (size_t threads = 1ul; threads <= max_threads; threads *= 2ul)
+		for (int kind = 0; kind < KIND_COUNT; ++kind)
+			bench_fork((enum Kind) kind, threads, depth);
+
+	printf("\npriority: %lu high tasks every %ld us over %lu low tasks per "
+	       "thread\n", HIGH_TASKS, HIGH_INTERVAL_NS / 1000l, LOW_PER_THREAD);
+	printf("%-7s %7s %12s %12s %9s\n",
+	       "pool", "threads", "mean us", "max us", "steals/1k");
+
+	for (size_t threads = 1ul; threads <= max_threads; threads *= 2ul)
+		for (int kind = 0; kind < KIND_COUNT; ++kind)
+			bench_priority((enum Kind) kind, threads);
+
+	return 0;
+}
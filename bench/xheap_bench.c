@@ -0,0 +1,110 @@
+#define _POSIX_C_SOURCE 200809L
+#include <utils/utils.h>
+#include <utils/rand.h>
+#include <bheap/bheap.h>
+#include <xheap/xheap.h>
+#include <bench/bench.h>
+
+/*			- xheap_bench.c -
+ * pushing 'factor' times the memory budget worth of 16-byte records through
+ * a 'struct XHeap', then draining it (checking extraction order), vs the same
+ * in an unbounded in-memory 'struct BHeap' when the data is at most
+ * BHEAP_LIMIT bytes
+ *
+ * usage: xheap_bench [budget MiB] [factor] [run directory]
+ */
+
+#define BHEAP_LIMIT (1ul << 30)
+
+static inline struct Record next_record(const size_t i)
+{
+	struct Record next = {
+		.key = (((uint64_t) pcg32_random_r(&_RNG)) << 32)
+		     | pcg32_random_r(&_RNG),
+		.id  = i
+	};
+
+	return next;
+}
+
+int main(int argc, char *argv[])
+{
+	const size_t budget = ((argc > 1)
+			       ? strtoul(argv[1], NULL, 10)
+			       : 16ul) << 20;
+	const size_t factor = (argc > 2)
+			    ? strtoul(argv[2], NULL, 10)
+			    : 10ul;
+	const char *const dir = (argc > 3) ? argv[3] : NULL;
+	const size_t length = factor * (budget / sizeof(struct Record));
+	struct XHeap *xheap;
+	struct BHeap *bheap;
+	struct Record next;
+	const struct Record *root;
+	uint64_t start, last;
+	double push_ns, pop_ns;
+	size_t count_runs;
+	bool ordered = true;
+
+	printf("%zu records (%zu MiB) through a %zu MiB budget\n"
+	       "\t%-8s %12s %12s %12s %12s\n",
+	       length, (length * sizeof(struct Record)) >> 20, budget >> 20,
+	       "heap", "push ns", "pop ns", "spilled MiB", "open runs");
+
+	seed_rng(42u);
+	xheap = init_xheap(sizeof(struct Record), budget, dir,
+			   &compare_record);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		next = next_record(i);
+		xheap_insert(xheap, &next);
+	}
+	push_ns    = bench_ns_per_op(start, bench_now_ns(), length);
+	count_runs = xheap->count_runs;
+
+	last  = 0lu;
+	start = bench_now_ns();
+	while ((root = xheap_extract(xheap)) != NULL) {
+		ordered &= (root->key >= last);
+		last	 = root->key;
+	}
+	pop_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	if (!ordered) {
+		puts("FAILED: xheap extraction out of order");
+		return EXIT_FAILURE;
+	}
+
+	printf("\t%-8s %12.2f %12.2f %12zu %12zu\n",
+	       "xheap", push_ns, pop_ns,
+	       (xheap->count_spilled * sizeof(struct Record)) >> 20,
+	       count_runs);
+
+	free_xheap(xheap);
+
+	if ((length * sizeof(struct Record)) > BHEAP_LIMIT)
+		return 0;
+
+	seed_rng(42u);
+	bheap = init_bheap(sizeof(struct Record), &compare_record);
+
+	start = bench_now_ns();
+	for (size_t i = 0ul; i < length; ++i) {
+		next = next_record(i);
+		bheap_insert(bheap, &next);
+	}
+	push_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	start = bench_now_ns();
+	while (bheap_extract(bheap) != NULL)
+		;
+	pop_ns = bench_ns_per_op(start, bench_now_ns(), length);
+
+	printf("\t%-8s %12.2f %12.2f %12s %12s\n",
+	       "bheap", push_ns, pop_ns, "-", "-");
+
+	free_bheap(bheap);
+
+	return 0;
+}
@@ -1,8 +1,211 @@
+#define _POSIX_C_SOURCE 200809L	/* mmap, fstat, clock_gettime */
+#include <fcntl.h>	/* open */
+#include <sys/mman.h>	/* mmap, munmap */
+#include <sys/stat.h>	/* fstat */
+#include <unistd.h>	/* write, close */
+#ifdef BHEAP_STATS_LATENCY
+#include <time.h>	/* clock_gettime */
+#endif /* ifdef BHEAP_STATS_LATENCY */
 #include <utils/utils.h>
+#include <stdbool.h>
 #include <bheap/bheap.h>
 
+/* one node copied one level along a shift; a shift placing its node */
+#define COUNT_LEVEL(width)					\
+	do {							\
+		BHEAP_STATS_ADD(sift_levels, 1lu);		\
+		BHEAP_STATS_ADD(bytes_moved, (width));		\
+	} while (0)
+
+#define COUNT_SIFT(width)					\
+	do {							\
+		BHEAP_STATS_ADD(sifts, 1lu);			\
+		BHEAP_STATS_ADD(bytes_moved, (width));		\
+	} while (0)
+
+/* binary heaps keep their dedicated routines
+ ******************************************************************************/
+static inline void shift_up(char *const nodes,
+			    const void *const next,
+			    const size_t width,
+			    const ptrdiff_t i_next,
+			    const unsigned int log_arity,
+			    int (*compare)(const void *,
+					   const void *))
+{
+	if (log_arity == 1u)
+		do_insert(nodes, next, width, i_next, compare);
+	else
+		do_dary_insert(nodes, next, width, i_next, log_arity, compare);
+}
+
+static inline void shift_down(char *const restrict nodes,
+			      const void *const restrict next,
+			      const size_t width,
+			      const ptrdiff_t i_next,
+			      const ptrdiff_t i_base,
+			      const unsigned int log_arity,
+			      const enum BHeapShiftMode shift_mode,
+			      int (*compare)(const void *,
+					     const void *))
+{
+	if (shift_mode == BHEAP_SHIFT_BOTTOM_UP) {
+		if (log_arity == 1u)
+			do_bheap_shift_bottom_up(nodes, next, width, i_next,
+						 i_base, compare);
+		else
+			do_dary_bheap_shift_bottom_up(nodes, next, width,
+						      i_next, i_base,
+						      log_arity, compare);
+	} else {
+		if (log_arity == 1u)
+			do_bheap_shift(nodes, next, width, i_next, i_base,
+				       compare);
+		else
+			do_dary_bheap_shift(nodes, next, width, i_next,
+					    i_base, log_arity, compare);
+	}
+}
+
+/* d-ary index math
+ ******************************************************************************/
+extern inline unsigned int bheap_log_arity(const size_t arity);
+
+extern inline ptrdiff_t bheap_i_child(const ptrdiff_t i_node,
+				      const unsigned int log_arity);
+
+extern inline ptrdiff_t bheap_i_parent(const ptrdiff_t i_node,
+				       const unsigned int log_arity);
+
+extern inline size_t bheap_block_pad(const void *const block,
+				     const size_t width);
+
+/* instrumentation
+ ******************************************************************************/
+#ifdef BHEAP_STATS
+__thread struct BHeap *bheap_stats_heap = NULL;
+
+int bheap_stats_compare(const void *x,
+			const void *y)
+{
+	struct BHeap *const heap = bheap_stats_heap;
+	int result;
+
+	++(heap->stats.compares);
+
+	result = heap->compare(x, y);
+
+	/* a comparator operating on a heap of its own retargets (then clears)
+	 * the counters: point them back at this one */
+	bheap_stats_heap = heap;
+
+	return result;
+}
+#endif /* ifdef BHEAP_STATS */
+
+#ifdef BHEAP_STATS_LATENCY
+uint64_t bheap_stats_start(struct BHeap *heap)
+{
+	struct timespec now;
+
+	if (((heap->stats.latency_ops)++ % BHEAP_STATS_SAMPLE) != 0lu)
+		return 0lu;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (((uint64_t) now.tv_sec) * 1000000000lu)
+	     + ((uint64_t) now.tv_nsec);
+}
+
+void bheap_stats_record(uint64_t *const histogram,
+			const uint64_t start)
+{
+	struct timespec now;
+	uint64_t elapsed;
+	int bucket;
+
+	if (start == 0lu)
+		return;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	elapsed = (((uint64_t) now.tv_sec) * 1000000000lu)
+		+ ((uint64_t) now.tv_nsec) - start;
+	bucket	= (elapsed == 0lu) ? 0 : (63 - __builtin_clzll(elapsed));
+
+	if (bucket >= BHEAP_STATS_BUCKETS)
+		bucket = BHEAP_STATS_BUCKETS - 1;
+
+	++histogram[bucket];
+}
+#endif /* ifdef BHEAP_STATS_LATENCY */
+
+extern inline void bheap_stats_count(struct BHeap *heap);
+
+extern inline struct BHeapStats bheap_stats(const struct BHeap *heap);
+
+extern inline void reset_bheap_stats(struct BHeap *heap);
+
+
 /* initialize, destroy, resize
  ******************************************************************************/
+static void *default_alloc(void *context,
+			   const size_t size)
+{
+	return malloc(size);
+}
+
+static void *default_realloc(void *context,
+			     void *block,
+			     const size_t prev_size,
+			     const size_t size)
+{
+	return realloc(block, size);
+}
+
+static void default_free(void *context,
+			 void *block,
+			 const size_t size)
+{
+	free(block);
+}
+
+const struct BHeapAllocator bheap_default_allocator = {
+	.alloc	 = &default_alloc,
+	.realloc = &default_realloc,
+	.free	 = &default_free,
+	.context = NULL
+};
+
+extern inline size_t bheap_block_size(const size_t width,
+				      const size_t alloc);
+
+extern inline void init_bheap_fields(struct BHeap *heap,
+				     const size_t width,
+				     const size_t alloc,
+				     const unsigned int log_arity,
+				     const struct BHeapAllocator *allocator,
+				     int (*compare)(const void *,
+						    const void *));
+
+extern inline struct BHeap *init_allocated_dary_bheap(const size_t width,
+						      const size_t size,
+						      const size_t arity,
+						      const struct BHeapAllocator *allocator,
+						      int (*compare)(const void *,
+								     const void *));
+
+extern inline struct BHeap *init_sized_dary_bheap(const size_t width,
+						  const size_t size,
+						  const size_t arity,
+						  int (*compare)(const void *,
+								 const void *));
+
+extern inline struct BHeap *init_dary_bheap(const size_t width,
+					    const size_t arity,
+					    int (*compare)(const void *,
+							   const void *));
+
 extern inline struct BHeap *init_bheap(const size_t width,
 				       int (*compare)(const void *,
 						      const void *));
@@ -12,22 +215,81 @@ extern inline struct BHeap *init_sized_bheap(const size_t width,
 					     int (*compare)(const void *,
 							    const void *));
 
+extern inline void set_bheap_shift_mode(struct BHeap *heap,
+					const enum BHeapShiftMode shift_mode);
+
+extern inline void clear_bheap(struct BHeap *heap);
+
 extern inline void free_bheap(struct BHeap *heap);
 
 
 extern inline void realloc_bheap(struct BHeap *heap,
 				 const size_t size);
 
+extern inline void set_bheap_shrink_ratio(struct BHeap *heap,
+					  const unsigned int shrink_ratio);
+
+extern inline void bheap_shrink(struct BHeap *heap);
+
+
+/* memory accounting
+ ******************************************************************************/
+extern inline size_t bheap_resident_bytes(const struct BHeap *heap);
+
+extern inline size_t bheap_peak_bytes(const struct BHeap *heap);
+
+
+/* lazy insertion
+ ******************************************************************************/
+void do_bheap_flush(struct BHeap *heap)
+{
+	char *const nodes	     = heap->nodes;
+	const size_t width	     = heap->width;
+	const size_t count_heap	     = heap->count - heap->count_lazy;
+	const unsigned int log_arity = heap->log_arity;
+	int (*compare)(const void *,
+		       const void *) = BHEAP_COMPARE(heap);
+
+	if ((heap->count_lazy * BHEAP_FLUSH_RATIO) >= count_heap) {
+		do_bheap_heapify(nodes, count_heap + 1ul, heap->count, width,
+				 log_arity, compare);
+
+	} else {
+		char next[width];
+
+		for (size_t i = count_heap + 1ul; i <= heap->count; ++i) {
+			memcpy(&next[0l], &nodes[i * width], width);
+			shift_up(nodes, &next[0l], width, i, log_arity, compare);
+		}
+	}
+
+	BHEAP_STATS_DONE();
+
+	heap->count_lazy = 0ul;
+}
+
+extern inline void bheap_flush(struct BHeap *heap);
+
+extern inline void set_bheap_flush_limit(struct BHeap *heap,
+					 const size_t flush_limit);
+
+extern inline void bheap_insert_lazy(struct BHeap *heap,
+				     const void *const next);
+
+extern inline const void *bheap_peek(struct BHeap *heap);
+
+
 /* insertion
  ******************************************************************************/
 extern inline void bheap_insert(struct BHeap *heap,
-				void *const next);
+				const void *const next);
 
 void bheap_insert_array(struct BHeap *heap,
-			void *const array,
+			const void *const array,
 			const size_t length)
 {
-	void *const nodes  = heap->nodes;
+	bheap_flush(heap);
+
 	const size_t count = heap->count;
 	const size_t width = heap->width;
 	const size_t next_count = count + length;
@@ -35,20 +297,38 @@ void bheap_insert_array(struct BHeap *heap,
 	if (heap->alloc < next_count)
 		realloc_bheap(heap, next_pow_two(next_count));
 
+	char *const nodes = heap->nodes;
+	const char *const next = (const char *) array;
+
+	const unsigned int log_arity = heap->log_arity;
 	int (*compare)(const void *,
-		       const void *) = heap->compare;
+		       const void *) = BHEAP_COMPARE(heap);
 
 
-	for (size_t i = 0ul; i < length; ++i)
-		do_insert(nodes, &array[i], count + i, width, compare);
+	/* bulk load: append and heapify in linear time */
+	if ((length * BHEAP_HEAPIFY_RATIO) >= count) {
+		memcpy(&nodes[(count + 1ul) * width], array, width * length);
+		BHEAP_STATS_ADD(bytes_moved, width * length);
+		do_bheap_heapify(nodes, count + 1ul, next_count, width,
+				 log_arity, compare);
+
+	} else {
+		for (size_t i = 0ul; i < length; ++i)
+			shift_up(nodes, &next[i * width], width,
+				 count + i + 1ul, log_arity, compare);
+	}
+
+	BHEAP_STATS_DONE();
 
 	heap->count = next_count;
+
+	bheap_stats_count(heap);
 }
 
 
 
-void do_insert(void *const nodes,
-	       void *const next,
+void do_insert(char *const nodes,
+	       const void *const next,
 	       const size_t width,
 	       const ptrdiff_t i_next,
 	       int (*compare)(const void *,
@@ -57,26 +337,61 @@ void do_insert(void *const nodes,
 	/* sentinel node has been reached, 'next' is new root node */
 	if (i_next == 1l) {
 		/* nodes[1l] = next; */
-		memcpy(&nodes[1l], next, width);
+		memcpy(&nodes[width], next, width);
+		COUNT_SIFT(width);
 		return;
 	}
 
 
 	const ptrdiff_t i_parent = i_next / 2l;
-	void *const parent = &nodes[i_parent];
+	char *const parent = &nodes[i_parent * width];
 
 	if (compare(parent, next)) {
 		/* nodes[i_next] = next; */
-		memcpy(&nodes[i_next], next, width);
+		memcpy(&nodes[i_next * width], next, width);
+		COUNT_SIFT(width);
 		return;
 	}
 
 	/* nodes[i_next] = parent; */
-	memcpy(&nodes[i_next], parent, width);
+	memcpy(&nodes[i_next * width], parent, width);
+	COUNT_LEVEL(width);
 	do_insert(nodes, next, width, i_parent, compare);
 }
 
 
+void do_dary_insert(char *const nodes,
+		    const void *const next,
+		    const size_t width,
+		    ptrdiff_t i_next,
+		    const unsigned int log_arity,
+		    int (*compare)(const void *,
+				   const void *))
+{
+	ptrdiff_t i_parent;
+	char *parent;
+
+	/* move parents down until sentinel node is reached or a parent that
+	 * belongs above 'next' is found */
+	while (i_next > 1l) {
+		i_parent = bheap_i_parent(i_next, log_arity);
+		parent	 = &nodes[i_parent * width];
+
+		if (compare(parent, next))
+			break;
+
+		/* nodes[i_next] = parent; */
+		memcpy(&nodes[i_next * width], parent, width);
+		COUNT_LEVEL(width);
+		i_next = i_parent;
+	}
+
+	/* nodes[i_next] = next; */
+	memcpy(&nodes[i_next * width], next, width);
+	COUNT_SIFT(width);
+}
+
+
 
 
 /* extraction
@@ -86,117 +401,924 @@ void *bheap_extract(struct BHeap *heap)
 	if (heap->count == 0ul)
 		return NULL;
 
-	void *const nodes = heap->nodes;
-	void *const root  = &nodes[1l];
-	void *const base  = &nodes[heap->count];
+#ifdef BHEAP_STATS_LATENCY
+	const uint64_t start = bheap_stats_start(heap);
+#endif /* ifdef BHEAP_STATS_LATENCY */
+
+	bheap_flush(heap);
+
+	/* before parking, so the returned slot survives the resize */
+	bheap_shrink(heap);
+
+	char *const nodes  = heap->nodes;
+	const size_t width = heap->width;
+	char *const root   = &nodes[width];
+	char *const base   = &nodes[heap->count * width];
+	char next[width];
 
 	--(heap->count);
 
-	do_bheap_shift(nodes, base, heap->width,
-		       1l, heap->count, heap->compare);
+	/* park 'root' in the vacated 'base' slot and shift old 'base' down from
+	 * the top */
+	memcpy(&next[0l], base, width);
+	memcpy(base,	  root, width);
+	BHEAP_STATS_ADD(bytes_moved, 2ul * width);
+
+	shift_down(nodes, &next[0l], width,
+		   1l, heap->count, heap->log_arity, heap->shift_mode,
+		   BHEAP_COMPARE(heap));
 
-	return root;
+	BHEAP_STATS_DONE();
+
+#ifdef BHEAP_STATS_LATENCY
+	bheap_stats_record(heap->stats.extract_ns, start);
+#endif /* ifdef BHEAP_STATS_LATENCY */
+
+	return base;
 }
 
-void do_bheap_shift(void *const restrict nodes,
-		    void *const restrict next,
-		    const size_t width,
-		    const ptrdiff_t i_next,
-		    const ptrdiff_t i_base,
-		    int (*compare)(const void *,
-				   const void *))
+
+/* replace-top, push-pop
+ ******************************************************************************/
+void bheap_replace_top(struct BHeap *heap,
+		       const void *const next)
+{
+	bheap_flush(heap);
+
+	if (heap->count == 0ul) {
+		bheap_insert(heap, next);
+		return;
+	}
+
+	shift_down(heap->nodes, next, heap->width,
+		   1l, heap->count, heap->log_arity, heap->shift_mode,
+		   BHEAP_COMPARE(heap));
+
+	BHEAP_STATS_DONE();
+}
+
+bool bheap_pushpop(struct BHeap *heap,
+		   const void *const next,
+		   void *const out)
+{
+	bheap_flush(heap);
+
+	const size_t width = heap->width;
+	char *const root   = &heap->nodes[width];
+	int (*compare)(const void *,
+		       const void *) = BHEAP_COMPARE(heap);
+
+	if ((heap->count == 0ul) || !compare(root, next)) {
+		BHEAP_STATS_DONE();
+		memcpy(out, next, width);
+		return false;
+	}
+
+	memcpy(out, root, width);
+	BHEAP_STATS_ADD(bytes_moved, width);
+
+	shift_down(heap->nodes, next, width,
+		   1l, heap->count, heap->log_arity, heap->shift_mode,
+		   compare);
+
+	BHEAP_STATS_DONE();
+
+	return true;
+}
+
+
+/* bounded top-K
+ ******************************************************************************/
+extern inline struct BHeap *init_topk_bheap(const size_t width,
+					    const size_t k,
+					    int (*compare)(const void *,
+							   const void *));
+
+extern inline bool bheap_topk_insert(struct BHeap *heap,
+				     const void *const next);
+
+size_t bheap_topk_sorted(const struct BHeap *heap,
+			 void *const out)
+{
+	const size_t width = heap->width;
+	char *const nodes  = ((char *) out) - width;
+	char next[width];
+
+	memcpy(out, &heap->nodes[width], heap->count * width);
+
+	/* order any lazy nodes in the copy */
+	if (heap->count_lazy != 0ul)
+		do_bheap_heapify(nodes, heap->count - heap->count_lazy + 1ul,
+				 heap->count, width, heap->log_arity,
+				 heap->compare);
+
+	/* the copy is now a heap: extract each root into the slot vacated
+	 * at its base, as heapsort does, leaving reverse extraction order */
+	for (ptrdiff_t i = heap->count; i > 1l; --i) {
+		memcpy(&next[0l],	  &nodes[i * width], width);
+		memcpy(&nodes[i * width], &nodes[width],     width);
+		shift_down(nodes, &next[0l], width, 1l, i - 1l,
+			   heap->log_arity, heap->shift_mode, heap->compare);
+	}
+
+	return heap->count;
+}
+
+
+/* candidate heap of node indices, ordered by the nodes they index
+ ******************************************************************************/
+static inline void candidates_insert(ptrdiff_t *const candidates,
+				     ptrdiff_t i_next,
+				     const ptrdiff_t i_node,
+				     const char *const nodes,
+				     const size_t width,
+				     int (*compare)(const void *,
+						    const void *))
+{
+	const char *const next = &nodes[i_node * width];
+	ptrdiff_t i_parent;
+
+	while (i_next > 1l) {
+		i_parent = i_next / 2l;
+
+		if (compare(&nodes[candidates[i_parent] * width], next))
+			break;
+
+		candidates[i_next] = candidates[i_parent];
+		i_next		   = i_parent;
+	}
+
+	candidates[i_next] = i_node;
+}
+
+/* bottom-up: the displaced base candidate usually belongs near the base */
+static inline void candidates_shift(ptrdiff_t *const candidates,
+				    const ptrdiff_t i_base,
+				    const ptrdiff_t i_node,
+				    const char *const nodes,
+				    const size_t width,
+				    int (*compare)(const void *,
+						   const void *))
+{
+	const char *const next = &nodes[i_node * width];
+	ptrdiff_t i_next = 1l;
+	ptrdiff_t i_child, i_parent;
+
+	while ((i_child = i_next * 2l) <= i_base) {
+		if ((i_child < i_base)
+		    && compare(&nodes[candidates[i_child + 1l] * width],
+			       &nodes[candidates[i_child] * width]))
+			++i_child;
+
+		candidates[i_next] = candidates[i_child];
+		i_next		   = i_child;
+	}
+
+	while (i_next > 1l) {
+		i_parent = i_next / 2l;
+
+		if (!compare(next, &nodes[candidates[i_parent] * width]))
+			break;
+
+		candidates[i_next] = candidates[i_parent];
+		i_next		   = i_parent;
+	}
+
+	candidates[i_next] = i_node;
+}
+
+/* scratch for one pass of 'bheap_extract_n', on the stack: passes take at most
+ * EXTRACT_N_HOLES nodes, fewer when wide nodes would overflow the candidates,
+ * and refill up to EXTRACT_N_WALKS holes at once */
+#define EXTRACT_N_HOLES	     256l
+#define EXTRACT_N_CANDIDATES 1024l
+#define EXTRACT_N_WALKS	     8l
+
+/* deepest (highest index) hole first */
+static int compare_hole(const void *x,
+			const void *y)
 {
+	const ptrdiff_t i_x = *((const ptrdiff_t *) x);
+	const ptrdiff_t i_y = *((const ptrdiff_t *) y);
+
+	return (i_x < i_y) - (i_x > i_y);
+}
+
+/* walks the 'count' holes at 'walks' down to the base in lockstep, promoting
+ * the best child at each level, then shifts the node at 'fillers[w]' back up
+ * into hole 'walks[w]': unlike consecutive extractions, the walks do not wait
+ * on one another, so their cache misses overlap */
+static void fill_holes(char *const nodes,
+		       const size_t width,
+		       ptrdiff_t *const walks,
+		       const ptrdiff_t *const fillers,
+		       const ptrdiff_t count,
+		       const ptrdiff_t i_base,
+		       const unsigned int log_arity,
+		       int (*compare)(const void *,
+				      const void *))
+{
+	const ptrdiff_t arity = 1l << log_arity;
+	ptrdiff_t tops[EXTRACT_N_WALKS];
+	ptrdiff_t count_active = count;
+	ptrdiff_t i_next, i_child, i_last, i_best, i_parent;
+	const char *next;
+
+	memcpy(&tops[0l], walks, sizeof(ptrdiff_t) * count);
+
+	while (count_active > 0l) {
+		count_active = 0l;
+
+		for (ptrdiff_t w = 0l; w < count; ++w) {
+			/* index 0 is the sentinel, never a hole */
+			if ((i_next = walks[w]) == 0l)
+				continue;
 
-	const ptrdiff_t i_lchild = i_next * 2l;
+			i_child = bheap_i_child(i_next, log_arity);
 
-	/* if base level of heap has been reached (no more children), replace
+			if (i_child > i_base) {
+				/* shift the filler back up, no higher than
+				 * the hole */
+				next = &nodes[fillers[w] * width];
+
+				while (i_next > tops[w]) {
+					i_parent = bheap_i_parent(i_next,
+								  log_arity);
+
+					if (!compare(next,
+						     &nodes[i_parent * width]))
+						break;
+
+					memcpy(&nodes[i_next * width],
+					       &nodes[i_parent * width], width);
+					COUNT_LEVEL(width);
+					i_next = i_parent;
+				}
+
+				memcpy(&nodes[i_next * width], next, width);
+				COUNT_SIFT(width);
+				walks[w] = 0l;
+				continue;
+			}
+
+			i_last = i_child + arity - 1l;
+
+			if (i_last > i_base)
+				i_last = i_base;
+
+			for (i_best = i_child++; i_child <= i_last; ++i_child)
+				if (compare(&nodes[i_child * width],
+					    &nodes[i_best * width]))
+					i_best = i_child;
+
+			memcpy(&nodes[i_next * width], &nodes[i_best * width],
+			       width);
+			COUNT_LEVEL(width);
+			walks[w] = i_best;
+
+			/* in flight while the other walks take their step */
+			i_child = bheap_i_child(i_best, log_arity);
+
+			if (i_child <= i_base)
+				__builtin_prefetch(&nodes[i_child * width]);
+
+			++count_active;
+		}
+	}
+}
+
+/* removes the best 'n' (<= EXTRACT_N_HOLES, <= 'count') nodes of 'heap' into
+ * 'buffer' in extraction order */
+static void extract_n_pass(struct BHeap *heap,
+			   char *const buffer,
+			   const ptrdiff_t n,
+			   int (*compare)(const void *,
+					  const void *))
+{
+	char *const nodes  = heap->nodes;
+	const size_t width = heap->width;
+	const unsigned int log_arity = heap->log_arity;
+	const ptrdiff_t arity  = 1l << log_arity;
+	const ptrdiff_t i_base = heap->count;
+	const ptrdiff_t i_tail = i_base - n;
+
+	ptrdiff_t holes[EXTRACT_N_HOLES];
+	ptrdiff_t candidates[EXTRACT_N_CANDIDATES];
+	bool tail_holes[EXTRACT_N_HOLES];
+	ptrdiff_t walks[EXTRACT_N_WALKS];
+	ptrdiff_t fillers[EXTRACT_N_WALKS];
+	ptrdiff_t count_candidates = 0l;
+	ptrdiff_t count_walks;
+	ptrdiff_t i_node, i_child, i_last, i_level;
+	ptrdiff_t i_fill = i_base;
+
+	/* the best 'n' nodes form a subtree containing the root: select them
+	 * in order by repeatedly taking the best of a small heap of candidate
+	 * indices (children of those already taken)
 	 **********************************************************************/
-	if (i_lchild > i_base) {
-		memcpy(&nodes[i_next], next, width);
-		/* nodes[i_next] = next; */
-		return;
+	/* sentinel candidate at index 0 */
+	candidates[++count_candidates] = 1l;
+
+	for (ptrdiff_t k = 0l; k < n; ++k) {
+		i_node = candidates[1l];
+
+		memcpy(&buffer[k * width], &nodes[i_node * width], width);
+		BHEAP_STATS_ADD(bytes_moved, width);
+		holes[k] = i_node;
+
+		--count_candidates;
+
+		if (count_candidates > 0l)
+			candidates_shift(candidates, count_candidates,
+					 candidates[count_candidates + 1l],
+					 nodes, width, compare);
+
+		/* the last pick needs no children */
+		if (k == (n - 1l))
+			break;
+
+		i_child = bheap_i_child(i_node, log_arity);
+		i_last	= i_child + arity - 1l;
+
+		if (i_last > i_base)
+			i_last = i_base;
+
+		for (; i_child <= i_last; ++i_child)
+			candidates_insert(candidates, ++count_candidates,
+					  i_child, nodes, width, compare);
 	}
 
-	const ptrdiff_t i_rchild = i_lchild + 1l;
+	/* the last 'n' slots drop out of the heap: their non-hole nodes refill
+	 * the holes that remain inside it
+	 **********************************************************************/
+	memset(&tail_holes[0l], 0, sizeof(tail_holes));
 
-	void *const restrict lchild = &nodes[i_lchild];
+	for (ptrdiff_t k = 0l; k < n; ++k)
+		if (holes[k] > i_tail)
+			tail_holes[holes[k] - i_tail - 1l] = true;
 
-	/* compare left child with 'next':
+	/* a hole is only taken after its parent, so filling holes deepest
+	 * first finds every subtree below a hole already a heap; holes of one
+	 * depth are never above one another and fill together
 	 *
-	 * if 'lchild' belongs above 'next'...
+	 * fillers come from the base and almost always sink back to it, so
+	 * they shift bottom-up regardless of 'shift_mode'
 	 **********************************************************************/
-	if (compare(lchild, next)) {
+	qsort(&holes[0l], (size_t) n, sizeof(ptrdiff_t), &compare_hole);
+
+	for (ptrdiff_t k = 0l; k < n;) {
+		count_walks = 0l;
+		i_level	    = 1l;
+
+		while (bheap_i_child(i_level, log_arity) <= holes[k])
+			i_level = bheap_i_child(i_level, log_arity);
+
+		for (; (k < n) && (holes[k] >= i_level)
+		       && (count_walks < EXTRACT_N_WALKS); ++k) {
+			if (holes[k] > i_tail)
+				continue;
+
+			while (tail_holes[i_fill - i_tail - 1l])
+				--i_fill;
+
+			walks[count_walks]     = holes[k];
+			fillers[count_walks++] = i_fill--;
+		}
+
+		fill_holes(nodes, width, walks, fillers, count_walks, i_tail,
+			   log_arity, compare);
+	}
+
+	heap->count = i_tail;
+}
+
+size_t bheap_extract_n(struct BHeap *heap,
+		       void *const out,
+		       size_t n)
+{
+	bheap_flush(heap);
+
+	if (n > heap->count)
+		n = heap->count;
+
+	if (n == 0ul)
+		return 0ul;
+
+	const ptrdiff_t arity = 1l << heap->log_arity;
+	char *buffer	      = (char *) out;
+	ptrdiff_t pass	      = (EXTRACT_N_CANDIDATES - 2l) / (arity - 1l);
+	int (*compare)(const void *,
+		       const void *) = BHEAP_COMPARE(heap);
+
+	if (pass > EXTRACT_N_HOLES)
+		pass = EXTRACT_N_HOLES;
+
+	/* the best of what is left after a pass are the next best overall */
+	for (size_t left = n; left > 0ul; left -= (size_t) pass) {
+		if (((size_t) pass) > left)
+			pass = (ptrdiff_t) left;
+
+		extract_n_pass(heap, buffer, pass, compare);
+		buffer += pass * heap->width;
+	}
+
+	BHEAP_STATS_DONE();
+
+	bheap_shrink(heap);
+
+	return n;
+}
+
+void do_bheap_shift(char *const restrict nodes,
+		    const void *const restrict next,
+		    const size_t width,
+		    ptrdiff_t i_next,
+		    const ptrdiff_t i_base,
+		    int (*compare)(const void *,
+				   const void *))
+{
+	ptrdiff_t i_child;
+	char *child;
+
+	while (1) {
+		i_child = i_next * 2l;
 
 		/* if base level of heap has been reached (no more children),
-		 * place 'next' below 'lchild' and return
+		 * replace
 		 **************************************************************/
-		if (i_rchild > i_base) {
-			memcpy(&nodes[i_lchild], next,   width);
-			memcpy(&nodes[i_next],   lchild, width);
-			/* nodes[i_lchild] = next; */
-			/* nodes[i_next]	= lchild; */
-			return;
-		}
+		if (i_child > i_base)
+			break;
 
-		void *const restrict rchild = &nodes[i_rchild];
+		child = &nodes[i_child * width];
 
 		/* compare left child with right child:
 		 *
-		 * if 'lchild' belongs above 'rchild'...
+		 * if 'rchild' belongs above 'lchild', continue down right
+		 * branch
 		 **************************************************************/
-		if (compare(lchild, rchild)) {
-			/* place 'lchild' at 'i_next' and continue recursion
-			 * down left branch
-			 ******************************************************/
-			/* nodes[i_next] = lchild; */
-			memcpy(&nodes[i_next], lchild, width);
-			do_bheap_shift(nodes, next, width,
-				       i_lchild, i_base, compare);
-
-		} else {
-			/* place 'rchild' at 'i_next' and continue recursion
-			 * down right branch
-			 ******************************************************/
-			/* nodes[i_next] = rchild; */
-			memcpy(&nodes[i_next], rchild, width);
-			do_bheap_shift(nodes, next, width,
-				       i_rchild, i_base, compare);
+		if ((i_child < i_base) && compare(&child[width], child)) {
+			++i_child;
+			child += width;
 		}
-		return;
+
+		/* otherwise, 'next' belongs above lchild and rchild: place at
+		 * 'i_next' and return
+		 **************************************************************/
+		if (!compare(child, next))
+			break;
+
+		/* nodes[i_next] = child; */
+		memcpy(&nodes[i_next * width], child, width);
+		COUNT_LEVEL(width);
+		i_next = i_child;
 	}
 
-	/* if base level of heap has been reached (no more children), place
-	 * 'next' above 'lchild' (new base/last element) and return
+	/* nodes[i_next] = next; */
+	memcpy(&nodes[i_next * width], next, width);
+	COUNT_SIFT(width);
+}
+
+
+void do_bheap_shift_bottom_up(char *const restrict nodes,
+			      const void *const restrict next,
+			      const size_t width,
+			      ptrdiff_t i_next,
+			      const ptrdiff_t i_base,
+			      int (*compare)(const void *,
+					     const void *))
+{
+	const ptrdiff_t i_top = i_next;
+	ptrdiff_t i_child, i_parent;
+	char *child, *parent;
+
+	/* walk the hole at 'i_next' down to a leaf, promoting the child that
+	 * belongs above its sibling at each level ('next' is not consulted)
 	 **********************************************************************/
-	if (i_rchild > i_base) {
-		/* nodes[i_next] = next; */
-		memcpy(&nodes[i_next], next, width);
-		return;
+	while ((i_child = i_next * 2l) <= i_base) {
+		child = &nodes[i_child * width];
+
+		if ((i_child < i_base) && compare(&child[width], child)) {
+			++i_child;
+			child += width;
+		}
+
+		/* nodes[i_next] = child; */
+		memcpy(&nodes[i_next * width], child, width);
+		COUNT_LEVEL(width);
+		i_next = i_child;
 	}
 
-	void *const rchild = &nodes[i_rchild];
+	/* shift 'next' back up from the leaf, no higher than 'i_top'
+	 **********************************************************************/
+	while (i_next > i_top) {
+		i_parent = i_next / 2l;
+		parent	 = &nodes[i_parent * width];
 
-	/* compare 'next' with right child:
-	 *
-	 * if 'rchild' belongs above 'next'...
+		if (!compare(next, parent))
+			break;
+
+		/* nodes[i_next] = parent; */
+		memcpy(&nodes[i_next * width], parent, width);
+		COUNT_LEVEL(width);
+		i_next = i_parent;
+	}
+
+	/* nodes[i_next] = next; */
+	memcpy(&nodes[i_next * width], next, width);
+	COUNT_SIFT(width);
+}
+
+
+void do_dary_bheap_shift(char *const restrict nodes,
+			 const void *const restrict next,
+			 const size_t width,
+			 ptrdiff_t i_next,
+			 const ptrdiff_t i_base,
+			 const unsigned int log_arity,
+			 int (*compare)(const void *,
+					const void *))
+{
+	ptrdiff_t i_child, i_last, i_top;
+	char *top;
+
+	while (1) {
+		i_child = bheap_i_child(i_next, log_arity);
+
+		/* base level of heap has been reached (no more children) */
+		if (i_child > i_base)
+			break;
+
+		i_last = i_child + (1l << log_arity) - 1l;
+
+		if (i_last > i_base)
+			i_last = i_base;
+
+		/* find the child that belongs above all of its siblings */
+		i_top = i_child;
+		top   = &nodes[i_top * width];
+
+		while (i_child < i_last) {
+			++i_child;
+
+			if (compare(&nodes[i_child * width], top)) {
+				i_top = i_child;
+				top   = &nodes[i_top * width];
+			}
+		}
+
+		/* 'next' belongs above all children */
+		if (!compare(top, next))
+			break;
+
+		/* nodes[i_next] = top; */
+		memcpy(&nodes[i_next * width], top, width);
+		COUNT_LEVEL(width);
+		i_next = i_top;
+	}
+
+	/* nodes[i_next] = next; */
+	memcpy(&nodes[i_next * width], next, width);
+	COUNT_SIFT(width);
+}
+
+
+void do_dary_bheap_shift_bottom_up(char *const restrict nodes,
+				   const void *const restrict next,
+				   const size_t width,
+				   ptrdiff_t i_next,
+				   const ptrdiff_t i_base,
+				   const unsigned int log_arity,
+				   int (*compare)(const void *,
+						  const void *))
+{
+	const ptrdiff_t i_root = i_next;
+	ptrdiff_t i_child, i_last, i_top, i_parent;
+	char *top, *parent;
+
+	/* walk the hole at 'i_next' down to a leaf, promoting the child that
+	 * belongs above all of its siblings at each level
 	 **********************************************************************/
-	if (compare(rchild, next)) {
-		/* nodes[i_next] = rchild; */
-		memcpy(&nodes[i_next], rchild, width);
-		do_bheap_shift(nodes, next, width, i_rchild, i_base, compare);
-		return;
+	while ((i_child = bheap_i_child(i_next, log_arity)) <= i_base) {
+		i_last = i_child + (1l << log_arity) - 1l;
+
+		if (i_last > i_base)
+			i_last = i_base;
+
+		i_top = i_child;
+		top   = &nodes[i_top * width];
+
+		while (i_child < i_last) {
+			++i_child;
+
+			if (compare(&nodes[i_child * width], top)) {
+				i_top = i_child;
+				top   = &nodes[i_top * width];
+			}
+		}
+
+		/* nodes[i_next] = top; */
+		memcpy(&nodes[i_next * width], top, width);
+		COUNT_LEVEL(width);
+		i_next = i_top;
 	}
 
-	/* otherwise, 'next' belongs above lchild and rchild: place at 'i_next'
-	 * and return
+	/* shift 'next' back up from the leaf, no higher than 'i_root'
 	 **********************************************************************/
+	while (i_next > i_root) {
+		i_parent = bheap_i_parent(i_next, log_arity);
+		parent	 = &nodes[i_parent * width];
+
+		if (!compare(next, parent))
+			break;
+
+		/* nodes[i_next] = parent; */
+		memcpy(&nodes[i_next * width], parent, width);
+		COUNT_LEVEL(width);
+		i_next = i_parent;
+	}
+
 	/* nodes[i_next] = next; */
-	memcpy(&nodes[i_next], next, width);
+	memcpy(&nodes[i_next * width], next, width);
+	COUNT_SIFT(width);
 }
 
 
 
 
+/* heapify
+ ******************************************************************************/
+extern inline void heapify_bheap_nodes(char *const nodes,
+				       const size_t length,
+				       const size_t width,
+				       int (*compare)(const void *,
+						      const void *));
+
+void heapify_dary_bheap_nodes(char *const nodes,
+			      const size_t length,
+			      const size_t width,
+			      const size_t arity,
+			      int (*compare)(const void *,
+					     const void *))
+{
+	do_bheap_heapify(nodes, 1l, length, width, bheap_log_arity(arity),
+			 compare);
+}
+
+void do_bheap_heapify(char *const nodes,
+		      const ptrdiff_t i_first,
+		      const ptrdiff_t i_base,
+		      const size_t width,
+		      const unsigned int log_arity,
+		      int (*compare)(const void *,
+				     const void *))
+{
+	if (i_base <= 1l)
+		return;
+
+	char next[width];
+
+	/* parents of appended nodes, then their parents, etc... */
+	ptrdiff_t i_lo = (i_first > 1l)
+		       ? bheap_i_parent(i_first, log_arity)
+		       : 1l;
+	ptrdiff_t i_hi = bheap_i_parent(i_base, log_arity);
+	ptrdiff_t i    = i_hi;
+
+	while (1) {
+		/* shift down in descending order so that every subtree below
+		 * 'i' is a heap by the time 'i' is reached */
+		for (; i >= i_lo; --i) {
+			memcpy(&next[0l], &nodes[i * width], width);
+			shift_down(nodes, &next[0l], width, i, i_base,
+				   log_arity, BHEAP_SHIFT_TOP_DOWN, compare);
+		}
+
+		if (i_lo == 1l)
+			return;
+
+		i_lo = bheap_i_parent(i_lo, log_arity);
+		i_hi = bheap_i_parent(i_hi, log_arity);
+
+		/* skip nodes already shifted when ranges overlap */
+		if (i_hi < i)
+			i = i_hi;
+	}
+}
+
+
+
+
+/* snapshot
+ ******************************************************************************/
+/* heap over a private file mapping, allocated as one block so that freeing
+ * the heap frees its allocator too */
+struct MappedBHeap {
+	struct BHeap heap;
+	struct BHeapAllocator allocator;
+	char *map;		/* NULL once the nodes have moved out */
+	size_t map_length;
+};
+
+static inline bool in_map(const struct MappedBHeap *mapped,
+			  const void *const block)
+{
+	return (mapped->map != NULL)
+	    && (((const char *) block) >= mapped->map)
+	    && (((const char *) block) < (mapped->map + mapped->map_length));
+}
+
+static void *mapped_alloc(void *context,
+			  const size_t size)
+{
+	(void) context;
+
+	return malloc(size);
+}
+
+static void *mapped_realloc(void *context,
+			    void *block,
+			    const size_t prev_size,
+			    const size_t size)
+{
+	struct MappedBHeap *const mapped = (struct MappedBHeap *) context;
+	size_t length;
+	char *next;
+
+	if (!in_map(mapped, block))
+		return realloc(block, size);
+
+	next = malloc(size);
+	if (next == NULL)
+		return NULL;
+
+	/* 'prev_size' overstates a mapped block near the end of the file */
+	length = (mapped->map + mapped->map_length) - ((char *) block);
+
+	if (length > prev_size)
+		length = prev_size;
+
+	if (length > size)
+		length = size;
+
+	memcpy(next, block, length);
+
+	(void) munmap(mapped->map, mapped->map_length);
+	mapped->map = NULL;
+
+	return next;
+}
+
+static void mapped_free(void *context,
+			void *block,
+			const size_t size)
+{
+	struct MappedBHeap *const mapped = (struct MappedBHeap *) context;
+
+	(void) size;
+
+	if (in_map(mapped, block)) {
+		(void) munmap(mapped->map, mapped->map_length);
+		mapped->map = NULL;
+	} else {
+		free(block);
+	}
+}
+
+static inline uint64_t snapshot_offset(const size_t width)
+{
+	const uint64_t end = sizeof(struct BHeapSnapshot) + width;
+
+	return ((end + BHEAP_CACHE_LINE - 1lu) & ~(BHEAP_CACHE_LINE - 1lu))
+	     - width;
+}
+
+static void write_all(const int fd,
+		      const void *const buffer,
+		      const size_t length)
+{
+	const char *next = (const char *) buffer;
+	const char *const end = next + length;
+	ssize_t count;
+
+	while (next < end) {
+		count = write(fd, next, end - next);
+
+		if (count < 0l)
+			EXIT_ON_FAILURE("failed to write %lu bytes of snapshot",
+					(size_t) (end - next));
+
+		next += count;
+	}
+}
+
+void bheap_save(struct BHeap *heap,
+		const int fd)
+{
+	bheap_flush(heap);
+
+	const char padding[BHEAP_CACHE_LINE] = { 0 };
+	struct BHeapSnapshot header = {
+		.version    = BHEAP_SNAPSHOT_VERSION,
+		.byte_order = BHEAP_SNAPSHOT_BYTE_ORDER,
+		.width	    = heap->width,
+		.count	    = heap->count,
+		.log_arity  = heap->log_arity,
+		.shift_mode = (uint32_t) heap->shift_mode,
+		.offset	    = snapshot_offset(heap->width)
+	};
+
+	memcpy(&header.magic[0l], BHEAP_SNAPSHOT_MAGIC, sizeof(header.magic));
+
+	write_all(fd, &header, sizeof(header));
+	write_all(fd, &padding[0l], header.offset - sizeof(header));
+	write_all(fd, &heap->nodes[heap->width], heap->width * heap->count);
+}
+
+struct BHeap *bheap_map(const char *const path,
+			int (*compare)(const void *,
+				       const void *))
+{
+	const struct BHeapSnapshot *header;
+	struct MappedBHeap *mapped;
+	struct BHeap *heap;
+	struct stat status;
+	size_t length;
+	char *map;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	if ((fstat(fd, &status) != 0)
+	    || (((size_t) status.st_size) < sizeof(struct BHeapSnapshot))) {
+		(void) close(fd);
+		return NULL;
+	}
+
+	length = (size_t) status.st_size;
+	map    = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	(void) close(fd);
+
+	if (map == MAP_FAILED)
+		return NULL;
+
+	header = (const struct BHeapSnapshot *) map;
+
+	if ((memcmp(&header->magic[0l], BHEAP_SNAPSHOT_MAGIC,
+		    sizeof(header->magic)) != 0)
+	    || (header->version != BHEAP_SNAPSHOT_VERSION)
+	    || (header->byte_order != BHEAP_SNAPSHOT_BYTE_ORDER)
+	    || (header->width == 0lu)
+	    || (header->log_arity < 1u)
+	    || (header->log_arity > bheap_log_arity(BHEAP_MAX_ARITY))
+	    || ((header->shift_mode != BHEAP_SHIFT_TOP_DOWN)
+		&& (header->shift_mode != BHEAP_SHIFT_BOTTOM_UP))
+	    || (header->offset < sizeof(struct BHeapSnapshot))
+	    || (header->offset > length)
+	    || (header->count > ((length - header->offset) / header->width))) {
+		(void) munmap(map, length);
+		return NULL;
+	}
+
+	/* nothing to map */
+	if (header->count == 0lu) {
+		heap = init_sized_dary_bheap(header->width,
+					     BHEAP_DEFAULT_ALLOC,
+					     1lu << header->log_arity,
+					     compare);
+		heap->shift_mode = (enum BHeapShiftMode) header->shift_mode;
+		(void) munmap(map, length);
+		return heap;
+	}
+
+	HANDLE_MALLOC(mapped, sizeof(struct MappedBHeap));
+
+	mapped->allocator.alloc	  = &mapped_alloc;
+	mapped->allocator.realloc = &mapped_realloc;
+	mapped->allocator.free	  = &mapped_free;
+	mapped->allocator.context = mapped;
+	mapped->map		  = map;
+	mapped->map_length	  = length;
+
+	heap = &mapped->heap;
+
+	/* sentinel node at index 0; 'block' sits within a cache line before
+	 * 'nodes[1]', as it does for heaps from 'init_allocated_dary_bheap' */
+	heap->nodes = map + header->offset - header->width;
+	heap->block = map + (header->offset & ~(BHEAP_CACHE_LINE - 1lu));
+
+	init_bheap_fields(heap, header->width, header->count,
+			  header->log_arity, &mapped->allocator, compare);
+
+	heap->count	 = header->count;
+	heap->shift_mode = (enum BHeapShiftMode) header->shift_mode;
+
+	return heap;
+}
+
+
 /* display
  ******************************************************************************/
 void print_bheap(struct BHeap *heap,
@@ -210,11 +1332,12 @@ void print_bheap(struct BHeap *heap,
 		return;
 	}
 
-	void *const nodes = heap->nodes;
+	char *const nodes  = heap->nodes;
+	const size_t width = heap->width;
 	char buffer[256];
 
 	for (size_t i = 1ul; i <= count; ++i) {
-		node_to_string(buffer, &nodes[i]);
+		node_to_string(buffer, &nodes[i * width]);
 		printf("nodes[%zu]:\n%s\n", i, buffer);
 	}
 }
@@ -230,26 +1353,62 @@ extern inline void bheap_sort(void *const array,
 			      int (*compare)(const void *,
 					     const void *));
 
-void sort_bheap_nodes(void *const nodes,
-		      const size_t length,
-		      const size_t width,
-		      int (*compare)(const void *,
-				     const void *))
+extern inline void sort_bheap_nodes(char *const nodes,
+				    const size_t length,
+				    const size_t width,
+				    int (*compare)(const void *,
+						   const void *));
+
+void sort_dary_bheap_nodes(char *const nodes,
+			   const size_t length,
+			   const size_t width,
+			   const size_t arity,
+			   int (*compare)(const void *,
+					  const void *))
 {
-	ptrdiff_t i = length;
-	void *next;
+	do_bheap_sort(nodes, length, width, bheap_log_arity(arity),
+		      BHEAP_SHIFT_MODE, compare);
+}
+
+void do_bheap_sort(char *const nodes,
+		   const size_t length,
+		   const size_t width,
+		   const unsigned int log_arity,
+		   const enum BHeapShiftMode shift_mode,
+		   int (*compare)(const void *,
+				  const void *))
+{
+	char next[width];
+	ptrdiff_t i;
 
-	while (i > 1l) {
-		next = &nodes[i];
-		--i;
-		do_bheap_shift(nodes, next, width, i, length, compare);
+	/* build heap in place */
+	do_bheap_heapify(nodes, 1l, length, width, log_arity, compare);
+
+	/* repeatedly extract root into the slot vacated at the base, leaving
+	 * nodes in reverse extraction order */
+	for (i = length; i > 1l; --i) {
+		memcpy(&next[0l],	  &nodes[i * width], width);
+		memcpy(&nodes[i * width], &nodes[width],     width);
+		shift_down(nodes, &next[0l], width, 1l, i - 1l, log_arity,
+			   shift_mode, compare);
 	}
+
+	/* reverse into extraction order */
+	for (ptrdiff_t j = length; i < j; ++i, --j)
+		mem_swap(&nodes[i * width], &nodes[j * width], width);
 }
 
 
 /* convienience, misc
  ******************************************************************************/
-extern inline struct BHeap *array_into_bheap(void *const array,
+extern inline struct BHeap *array_into_dary_bheap(const void *const array,
+						  const size_t length,
+						  const size_t width,
+						  const size_t arity,
+						  int (*compare)(const void *,
+								 const void *));
+
+extern inline struct BHeap *array_into_bheap(const void *const array,
 					     const size_t length,
 					     const size_t width,
 					     int (*compare)(const void *,
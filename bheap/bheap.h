@@ -1,94 +1,550 @@
 #ifndef BHEAP_BHEAP_H_
 #define BHEAP_BHEAP_H_
+#include <stdbool.h>		/* bool */
+#include <stdint.h>		/* uint64_t */
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE, mem_swap */
+
+/*			- bheap.h -
+ * d-ary heap of fixed-width nodes stored in a 1-based array ('nodes[0]' is a
+ * sentinel that is never dereferenced)
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ *
+ * 'arity' is a power of two in [2, BHEAP_MAX_ARITY]; the children of node 'i'
+ * are nodes '((i - 1) * arity) + 2' through '(i * arity) + 1', and the array is
+ * offset so that 'nodes[2]' starts a cache line.  When 'arity * width' is a
+ * multiple (or divisor) of BHEAP_CACHE_LINE, every set of siblings then shares
+ * a line (or lines) of its own.
+ */
+
+#define BHEAP_DEFAULT_ALLOC 16ul
+#define BHEAP_CACHE_LINE    64ul
+#define BHEAP_MAX_ARITY     64ul
+
+/* compile-time default for 'init_bheap', 'init_sized_bheap', 'bheap_sort' */
+#ifndef BHEAP_ARITY
+#define BHEAP_ARITY 2ul
+#endif /* ifndef BHEAP_ARITY */
+
+/* how extraction and heapsort shift a node down from the root:
+ *
+ *	BHEAP_SHIFT_TOP_DOWN	compare 'next' against the top child at every
+ *				level, stopping as soon as 'next' belongs above
+ *				it
+ *
+ *	BHEAP_SHIFT_BOTTOM_UP	walk the hole down to a leaf comparing only
+ *				children with each other, then shift 'next' back
+ *				up (Wegener) -- about half the comparisons when
+ *				'next' usually belongs near the base, as it does
+ *				after an extraction
+ */
+enum BHeapShiftMode {
+	BHEAP_SHIFT_TOP_DOWN,
+	BHEAP_SHIFT_BOTTOM_UP
+};
+
+/* compile-time default for new heaps and 'sort_bheap_nodes' */
+#ifndef BHEAP_SHIFT_MODE
+#define BHEAP_SHIFT_MODE BHEAP_SHIFT_TOP_DOWN
+#endif /* ifndef BHEAP_SHIFT_MODE */
+
+/* 'bheap_insert_array' appends and heapifies in linear time instead of
+ * shifting up each node when 'length * BHEAP_HEAPIFY_RATIO >= count' */
+#ifndef BHEAP_HEAPIFY_RATIO
+#define BHEAP_HEAPIFY_RATIO 2ul
+#endif /* ifndef BHEAP_HEAPIFY_RATIO */
+
+/* 'bheap_flush' heapifies the lazy tail instead of shifting up each node when
+ * 'count_lazy * BHEAP_FLUSH_RATIO >= count - count_lazy' -- a shorter tail
+ * than 'bheap_insert_array' needs, since heapifying costs a few comparisons
+ * per node where a shift up may cost the full height */
+#ifndef BHEAP_FLUSH_RATIO
+#define BHEAP_FLUSH_RATIO 64ul
+#endif /* ifndef BHEAP_FLUSH_RATIO */
+
+/* instrumentation: defining BHEAP_STATS (for the library and every user
+ * alike, since it changes 'struct BHeap') gives each heap a 'struct
+ * BHeapStats' updated by the heap-level operations, e.g.
+ *
+ *	make -B DEFS=-DBHEAP_STATS ...
+ *
+ * BHEAP_STATS_LATENCY (which implies BHEAP_STATS) additionally times every
+ * BHEAP_STATS_SAMPLE-th insertion and extraction into log2 histograms.
+ * Without either, 'bheap_stats' returns zeros and nothing is counted. */
+#ifdef BHEAP_STATS_LATENCY
+#ifndef BHEAP_STATS
+#define BHEAP_STATS
+#endif /* ifndef BHEAP_STATS */
+#ifndef BHEAP_STATS_SAMPLE
+#define BHEAP_STATS_SAMPLE 64lu
+#endif /* ifndef BHEAP_STATS_SAMPLE */
+#endif /* ifdef BHEAP_STATS_LATENCY */
+
+/* bucket 'b' counts sampled latencies in [2^b, 2^(b + 1)) ns */
+#define BHEAP_STATS_BUCKETS 32
+
+struct BHeapStats {
+	uint64_t compares;
+	uint64_t bytes_moved;	/* node bytes copied into, within, out of heap */
+	uint64_t sifts;		/* shifts up or down */
+	uint64_t sift_levels;	/* levels crossed over all 'sifts' */
+	uint64_t reallocs;
+	size_t peak_count;
+	uint64_t latency_ops;	/* insertions and extractions seen */
+	uint64_t insert_ns[BHEAP_STATS_BUCKETS];
+	uint64_t extract_ns[BHEAP_STATS_BUCKETS];
+};
+
+/* allocation hooks: the heap and its node block are obtained from 'alloc',
+ * resized by 'realloc' and returned to 'free', each passed 'context' and the
+ * byte sizes involved (so arenas and pools need no headers of their own) */
+struct BHeapAllocator {
+	void *(*alloc)(void *context,
+		       const size_t size);
+	void *(*realloc)(void *context,
+			 void *block,
+			 const size_t prev_size,
+			 const size_t size);
+	void (*free)(void *context,
+		     void *block,
+		     const size_t size);
+	void *context;
+};
+
+/* malloc, realloc, free */
+extern const struct BHeapAllocator bheap_default_allocator;
+
 struct BHeap {
-	size_t count;	/* count of occupied nodes */
-	size_t alloc;	/* count of allocated nodes */
-	size_t width;	/* byte size per node */
-	void *nodes;
+	size_t count;		/* count of occupied nodes */
+	size_t count_lazy;	/* of which trailing, not yet in heap order */
+	size_t flush_limit;	/* 0: merge lazy nodes only on demand */
+	size_t alloc;		/* count of allocated nodes */
+	size_t peak_alloc;	/* greatest 'alloc' over the heap's life */
+	size_t width;		/* byte size per node */
+	unsigned int log_arity;	/* log2 of children per node */
+	unsigned int shrink_ratio;	/* 0: never shrink, see below */
+	enum BHeapShiftMode shift_mode;
+	char *nodes;
+	void *block;		/* allocation backing 'nodes' */
+	const struct BHeapAllocator *allocator;
 	int (*compare)(const void *,
 		       const void *);
+#ifdef BHEAP_STATS
+	struct BHeapStats stats;
+#endif /* ifdef BHEAP_STATS */
 };
 
+/* instrumentation hooks (no-ops unless BHEAP_STATS)
+ *
+ * BHEAP_COMPARE(heap) names the heap being operated on in this thread and
+ * yields a comparator that counts calls against it; shift routines then count
+ * their levels and copies against the same heap until BHEAP_STATS_DONE().
+ ******************************************************************************/
+#ifdef BHEAP_STATS
+extern __thread struct BHeap *bheap_stats_heap;
+
+int bheap_stats_compare(const void *x,
+			const void *y);
+
+#define BHEAP_COMPARE(heap)	  (bheap_stats_heap = (heap), \
+				   &bheap_stats_compare)
+#define BHEAP_STATS_DONE()	  ((void) (bheap_stats_heap = NULL))
+#define BHEAP_STATS_ADD(field, n) \
+	do { \
+		if (bheap_stats_heap != NULL) \
+			bheap_stats_heap->stats.field += (n); \
+	} while (0)
+#else
+#define BHEAP_COMPARE(heap)	  ((heap)->compare)
+#define BHEAP_STATS_DONE()	  ((void) 0)
+#define BHEAP_STATS_ADD(field, n) do { } while (0)
+#endif /* ifdef BHEAP_STATS */
+
+#ifdef BHEAP_STATS_LATENCY
+/* CLOCK_MONOTONIC ns if this operation is sampled, otherwise 0 */
+uint64_t bheap_stats_start(struct BHeap *heap);
+
+void bheap_stats_record(uint64_t *const histogram,
+			const uint64_t start);
+#endif /* ifdef BHEAP_STATS_LATENCY */
+
+inline void bheap_stats_count(struct BHeap *heap)
+{
+#ifdef BHEAP_STATS
+	if (heap->count > heap->stats.peak_count)
+		heap->stats.peak_count = heap->count;
+#else
+	(void) heap;
+#endif /* ifdef BHEAP_STATS */
+}
+
+/* returns 'heap's counters (all zero unless built with BHEAP_STATS) */
+inline struct BHeapStats bheap_stats(const struct BHeap *heap)
+{
+#ifdef BHEAP_STATS
+	return heap->stats;
+#else
+	const struct BHeapStats stats = { 0lu };
+
+	(void) heap;
+
+	return stats;
+#endif /* ifdef BHEAP_STATS */
+}
+
+inline void reset_bheap_stats(struct BHeap *heap)
+{
+#ifdef BHEAP_STATS
+	memset(&heap->stats, 0, sizeof(struct BHeapStats));
+	heap->stats.peak_count = heap->count;
+#else
+	(void) heap;
+#endif /* ifdef BHEAP_STATS */
+}
+
+/* d-ary index math
+ ******************************************************************************/
+inline unsigned int bheap_log_arity(const size_t arity)
+{
+	if ((arity < 2ul) || (arity > BHEAP_MAX_ARITY)
+	    || ((arity & (arity - 1ul)) != 0ul))
+		EXIT_ON_FAILURE("arity (%lu) must be a power of two in [2, %lu]",
+				arity, BHEAP_MAX_ARITY);
+
+	return (unsigned int) __builtin_ctzl(arity);
+}
+
+inline ptrdiff_t bheap_i_child(const ptrdiff_t i_node,
+			       const unsigned int log_arity)
+{
+	return ((i_node - 1l) << log_arity) + 2l;
+}
+
+inline ptrdiff_t bheap_i_parent(const ptrdiff_t i_node,
+				const unsigned int log_arity)
+{
+	return ((i_node - 2l) >> log_arity) + 1l;
+}
+
+/* offset from 'block' to 'nodes[1]' that puts 'nodes[2]' on a cache line */
+inline size_t bheap_block_pad(const void *const block,
+			      const size_t width)
+{
+	return (BHEAP_CACHE_LINE - ((((size_t) block) + width)
+				    % BHEAP_CACHE_LINE))
+	     % BHEAP_CACHE_LINE;
+}
+
 /* initialize, destroy, resize
  ******************************************************************************/
-inline struct BHeap *init_sized_bheap(const size_t width,
-				      const size_t size,
-				      int (*compare)(const void *,
-						     const void *))
+/* bytes backing 'alloc' nodes of 'width' (with room to align 'nodes[2]') */
+inline size_t bheap_block_size(const size_t width,
+			       const size_t alloc)
+{
+	return (width * alloc) + BHEAP_CACHE_LINE;
+}
+
+/* sets every field but 'nodes' and 'block' to those of an empty heap of
+ * 'alloc' nodes (shared by every constructor, mapped heaps included) */
+inline void init_bheap_fields(struct BHeap *heap,
+			      const size_t width,
+			      const size_t alloc,
+			      const unsigned int log_arity,
+			      const struct BHeapAllocator *allocator,
+			      int (*compare)(const void *,
+					     const void *))
+{
+	heap->count	   = 0ul;
+	heap->count_lazy   = 0ul;
+	heap->flush_limit  = 0ul;
+	heap->alloc	   = alloc;
+	heap->peak_alloc   = alloc;
+	heap->width	   = width;
+	heap->log_arity	   = log_arity;
+	heap->shrink_ratio = 0u;
+	heap->shift_mode   = BHEAP_SHIFT_MODE;
+	heap->allocator	   = allocator;
+	heap->compare	   = compare;
+
+	reset_bheap_stats(heap);
+}
+
+inline struct BHeap *init_allocated_dary_bheap(const size_t width,
+					       const size_t size,
+					       const size_t arity,
+					       const struct BHeapAllocator *allocator,
+					       int (*compare)(const void *,
+							      const void *))
 {
+	/* growth doubles 'alloc', which must not start at 0 */
+	const size_t alloc	     = (size == 0ul) ? BHEAP_DEFAULT_ALLOC : size;
+	const unsigned int log_arity = bheap_log_arity(arity);
+	const size_t block_size	     = bheap_block_size(width, alloc);
 	struct BHeap *heap;
 
-	HANDLE_MALLOC(heap, sizeof(struct BHeap));
-	HANDLE_MALLOC(heap->nodes, size);
+	heap = allocator->alloc(allocator->context, sizeof(struct BHeap));
+	if (heap == NULL)
+		EXIT_ON_FAILURE("failed to allocate %lu bytes",
+				sizeof(struct BHeap));
 
-	/* sentinel node at index 0 in */
-	--(heap->nodes);
+	heap->block = allocator->alloc(allocator->context, block_size);
+	if (heap->block == NULL)
+		EXIT_ON_FAILURE("failed to allocate %lu bytes", block_size);
 
-	heap->count   = 0ul;
-	heap->alloc   = size;
-	heap->width   = width;
-	heap->compare = compare;
+	/* sentinel node at index 0 */
+	heap->nodes = ((char *) heap->block)
+		    + bheap_block_pad(heap->block, width)
+		    - width;
+
+	init_bheap_fields(heap, width, alloc, log_arity, allocator, compare);
 
 	return heap;
 }
 
+inline struct BHeap *init_sized_dary_bheap(const size_t width,
+					   const size_t size,
+					   const size_t arity,
+					   int (*compare)(const void *,
+							  const void *))
+{
+	return init_allocated_dary_bheap(width, size, arity,
+					 &bheap_default_allocator, compare);
+}
+
+inline struct BHeap *init_dary_bheap(const size_t width,
+				     const size_t arity,
+				     int (*compare)(const void *,
+						    const void *))
+{
+	return init_sized_dary_bheap(width, BHEAP_DEFAULT_ALLOC, arity,
+				     compare);
+}
+
+inline struct BHeap *init_sized_bheap(const size_t width,
+				      const size_t size,
+				      int (*compare)(const void *,
+						     const void *))
+{
+	return init_sized_dary_bheap(width, size, BHEAP_ARITY, compare);
+}
+
 inline struct BHeap *init_bheap(const size_t width,
 				int (*compare)(const void *,
 					       const void *))
 {
-	return init_sized_bheap(width, width, compare);
+	return init_sized_bheap(width, BHEAP_DEFAULT_ALLOC, compare);
 }
 
 
+inline void set_bheap_shift_mode(struct BHeap *heap,
+				 const enum BHeapShiftMode shift_mode)
+{
+	heap->shift_mode = shift_mode;
+}
+
 inline void clear_bheap(struct BHeap *heap)
 {
-	heap->count = 0ul;
+	heap->count	 = 0ul;
+	heap->count_lazy = 0ul;
 }
 
 inline void free_bheap(struct BHeap *heap)
 {
-	free(&heap->nodes[1l]);
-	free(heap);
+	const struct BHeapAllocator *const allocator = heap->allocator;
+
+	allocator->free(allocator->context, heap->block,
+			bheap_block_size(heap->width, heap->alloc));
+	allocator->free(allocator->context, heap, sizeof(struct BHeap));
 }
 
 inline void realloc_bheap(struct BHeap *heap,
 			  const size_t alloc)
 {
-	void *nodes = realloc(&heap->nodes[1l], heap->width * alloc);
-
-	if (nodes == NULL)
+	const struct BHeapAllocator *const allocator = heap->allocator;
+	const size_t width    = heap->width;
+	const size_t prev_pad = ((size_t) (&heap->nodes[width]))
+			      - ((size_t) heap->block);
+	char *block = allocator->realloc(allocator->context, heap->block,
+					 bheap_block_size(width, heap->alloc),
+					 bheap_block_size(width, alloc));
+
+	if (block == NULL)
 		EXIT_ON_FAILURE("failed to reallocate number of nodes"
 				"from %lu to %lu",
 				heap->alloc, alloc);
 
-	heap->nodes = &nodes[-1l];
+	const size_t next_pad = bheap_block_pad(block, width);
+
+	/* realloc may not preserve cache line alignment */
+	if (next_pad != prev_pad) {
+		memmove(&block[next_pad],
+			&block[prev_pad],
+			width * heap->count);
+#ifdef BHEAP_STATS
+		heap->stats.bytes_moved += width * heap->count;
+#endif /* ifdef BHEAP_STATS */
+	}
+
+#ifdef BHEAP_STATS
+	++(heap->stats.reallocs);
+#endif /* ifdef BHEAP_STATS */
+
+	heap->block = block;
+	heap->nodes = &block[next_pad] - width;
 	heap->alloc = alloc;
+
+	if (alloc > heap->peak_alloc)
+		heap->peak_alloc = alloc;
 }
 
+/* shrink policy: with a 'shrink_ratio' of 'r' (0 to disable, the default, or
+ * at least 3), extraction halves 'alloc' once 'count * r <= alloc'.  Growth
+ * doubles at 'count == alloc', so a heap hovering around one size never
+ * oscillates between the two. */
+inline void set_bheap_shrink_ratio(struct BHeap *heap,
+				   const unsigned int shrink_ratio)
+{
+	if ((shrink_ratio != 0u) && (shrink_ratio < 3u))
+		EXIT_ON_FAILURE("shrink ratio (%u) must be 0 or at least 3",
+				shrink_ratio);
+
+	heap->shrink_ratio = shrink_ratio;
+}
+
+inline void bheap_shrink(struct BHeap *heap)
+{
+	if ((heap->shrink_ratio != 0u)
+	    && (heap->alloc > BHEAP_DEFAULT_ALLOC)
+	    && ((heap->count * heap->shrink_ratio) <= heap->alloc))
+		realloc_bheap(heap, heap->alloc / 2ul);
+}
+
+
+/* memory accounting
+ ******************************************************************************/
+/* bytes currently held from the allocator */
+inline size_t bheap_resident_bytes(const struct BHeap *heap)
+{
+	return sizeof(struct BHeap) + bheap_block_size(heap->width,
+							heap->alloc);
+}
+
+/* most bytes ever held from the allocator at once (ignoring the transient
+ * overlap inside 'realloc') */
+inline size_t bheap_peak_bytes(const struct BHeap *heap)
+{
+	return sizeof(struct BHeap) + bheap_block_size(heap->width,
+							heap->peak_alloc);
+}
+
+
+
+/* lazy insertion
+ *
+ * 'bheap_insert_lazy' appends to an unordered tail of 'count_lazy' nodes in
+ * O(1).  'bheap_flush' merges the tail into the heap, heapifying in linear
+ * time unless it is short relative to the heap (see BHEAP_FLUSH_RATIO), in
+ * which case each node is shifted up.  Every operation that needs heap order
+ * (insertion, extraction, peek, replace-top, push-pop, top-K, snapshot)
+ * flushes first, so the root is only valid through 'bheap_peek' while nodes
+ * are pending.
+ ******************************************************************************/
+void do_bheap_flush(struct BHeap *heap);
+
+inline void bheap_flush(struct BHeap *heap)
+{
+	if (heap->count_lazy != 0ul)
+		do_bheap_flush(heap);
+}
+
+/* with a 'flush_limit' of 'n' (0, the default, for none), the tail is also
+ * merged as soon as it holds 'n' nodes, bounding the work left for the next
+ * extraction */
+inline void set_bheap_flush_limit(struct BHeap *heap,
+				  const size_t flush_limit)
+{
+	heap->flush_limit = flush_limit;
+}
+
+inline void bheap_insert_lazy(struct BHeap *heap,
+			      const void *const next)
+{
+	++(heap->count);
+
+	if (heap->count > heap->alloc)
+		realloc_bheap(heap, heap->alloc * 2ul);
+
+	memcpy(&heap->nodes[heap->count * heap->width], next, heap->width);
+
+#ifdef BHEAP_STATS
+	heap->stats.bytes_moved += heap->width;
+#endif /* ifdef BHEAP_STATS */
+
+	bheap_stats_count(heap);
+
+	if (++(heap->count_lazy) == heap->flush_limit)
+		do_bheap_flush(heap);
+}
+
+/* flushes and returns the root, NULL if empty */
+inline const void *bheap_peek(struct BHeap *heap)
+{
+	bheap_flush(heap);
+
+	return (heap->count == 0ul)
+	     ? NULL
+	     : &heap->nodes[heap->width];
+}
 
 
 /* insertion
  ******************************************************************************/
-void do_insert(void *const nodes,
-	       void *const next,
+void do_insert(char *const nodes,
+	       const void *const next,
 	       const size_t width,
 	       const ptrdiff_t i_next,
 	       int (*compare)(const void *,
 			      const void *));
 
+void do_dary_insert(char *const nodes,
+		    const void *const next,
+		    const size_t width,
+		    const ptrdiff_t i_next,
+		    const unsigned int log_arity,
+		    int (*compare)(const void *,
+				   const void *));
+
 void bheap_insert_array(struct BHeap *heap,
-			void *const array,
+			const void *const array,
 			const size_t length);
 
 inline void bheap_insert(struct BHeap *heap,
-			 void *const next)
+			 const void *const next)
 {
+#ifdef BHEAP_STATS_LATENCY
+	const uint64_t start = bheap_stats_start(heap);
+#endif /* ifdef BHEAP_STATS_LATENCY */
+
+	bheap_flush(heap);
+
 	++(heap->count);
 
-	if (heap->count == heap->alloc)
+	if (heap->count > heap->alloc)
 		realloc_bheap(heap, heap->alloc * 2ul);
 
-	do_insert(heap->nodes, next, heap->count, heap->width, heap->compare);
+	if (heap->log_arity == 1u)
+		do_insert(heap->nodes, next, heap->width, heap->count,
+			  BHEAP_COMPARE(heap));
+	else
+		do_dary_insert(heap->nodes, next, heap->width, heap->count,
+			       heap->log_arity, BHEAP_COMPARE(heap));
+
+	BHEAP_STATS_DONE();
+	bheap_stats_count(heap);
+
+#ifdef BHEAP_STATS_LATENCY
+	bheap_stats_record(heap->stats.insert_ns, start);
+#endif /* ifdef BHEAP_STATS_LATENCY */
 }
 
 
@@ -96,16 +552,178 @@ inline void bheap_insert(struct BHeap *heap,
 
 /* extraction
  ******************************************************************************/
+/* returns a pointer to the extracted node, valid until the next call that
+ * modifies 'heap' */
 void *bheap_extract(struct BHeap *heap);
 
-void do_bheap_shift(void *const restrict nodes,
-		    void *const restrict next,
+/* copies the best 'n' nodes (fewer if 'count' < 'n') into 'out' in extraction
+ * order and removes them from 'heap' in one pass, returning the count copied */
+size_t bheap_extract_n(struct BHeap *heap,
+		       void *const out,
+		       size_t n);
+
+/* replace-top, push-pop
+ ******************************************************************************/
+/* overwrites the root with 'next' (which must not point into 'heap') and
+ * shifts it down once -- an extraction and insertion for the cost of one
+ * shift -- or inserts 'next' into an empty heap */
+void bheap_replace_top(struct BHeap *heap,
+		       const void *const next);
+
+/* inserts 'next' and extracts the best node into 'out' in one step: if 'next'
+ * would be extracted before the root (or the heap is empty) it is copied
+ * straight to 'out' after one comparison, otherwise the root is copied and
+ * replaced by 'next'.  Returns true if 'next' was kept. */
+bool bheap_pushpop(struct BHeap *heap,
+		   const void *const next,
+		   void *const out);
+
+
+/* bounded top-K
+ ******************************************************************************/
+/* A top-K heap keeps, of all nodes offered, the 'k' that would be extracted
+ * last; its root is the first of those to be displaced.  Capacity is 'alloc',
+ * so offering never reallocates (leave the shrink ratio at 0). */
+inline struct BHeap *init_topk_bheap(const size_t width,
+				     const size_t k,
+				     int (*compare)(const void *,
+						    const void *))
+{
+	if (k == 0ul)
+		EXIT_ON_FAILURE("top-K heap needs a positive 'k'");
+
+	return init_sized_bheap(width, k, compare);
+}
+
+/* offers 'next', returning true if it was kept; once full, a node that does not
+ * belong below the root is rejected after one comparison */
+inline bool bheap_topk_insert(struct BHeap *heap,
+			      const void *const next)
+{
+	bheap_flush(heap);
+
+	if (heap->count < heap->alloc) {
+		bheap_insert(heap, next);
+		return true;
+	}
+
+	const bool kept = BHEAP_COMPARE(heap)(&heap->nodes[heap->width], next);
+
+	BHEAP_STATS_DONE();
+
+	if (!kept)
+		return false;
+
+	bheap_replace_top(heap, next);
+	return true;
+}
+
+/* copies the kept nodes into 'out' in reverse extraction order (the best of
+ * the top K first), leaving 'heap' unchanged, and returns their count */
+size_t bheap_topk_sorted(const struct BHeap *heap,
+			 void *const out);
+
+
+/* shift primitives
+ ******************************************************************************/
+void do_bheap_shift(char *const restrict nodes,
+		    const void *const restrict next,
 		    const size_t width,
 		    const ptrdiff_t i_next,
 		    const ptrdiff_t i_base,
 		    int (*compare)(const void *,
 				   const void *));
 
+void do_dary_bheap_shift(char *const restrict nodes,
+			 const void *const restrict next,
+			 const size_t width,
+			 const ptrdiff_t i_next,
+			 const ptrdiff_t i_base,
+			 const unsigned int log_arity,
+			 int (*compare)(const void *,
+					const void *));
+
+void do_bheap_shift_bottom_up(char *const restrict nodes,
+			      const void *const restrict next,
+			      const size_t width,
+			      const ptrdiff_t i_next,
+			      const ptrdiff_t i_base,
+			      int (*compare)(const void *,
+					     const void *));
+
+void do_dary_bheap_shift_bottom_up(char *const restrict nodes,
+				   const void *const restrict next,
+				   const size_t width,
+				   const ptrdiff_t i_next,
+				   const ptrdiff_t i_base,
+				   const unsigned int log_arity,
+				   int (*compare)(const void *,
+						  const void *));
+
+
+/* heapify (Floyd, bottom-up, linear time)
+ ******************************************************************************/
+/* restores heap order to 1-based 'nodes[1 .. i_base]' after 'nodes[i_first ..
+ * i_base]' have been appended to the heap 'nodes[1 .. i_first - 1]', shifting
+ * down only ancestors of the appended nodes */
+void do_bheap_heapify(char *const nodes,
+		      const ptrdiff_t i_first,
+		      const ptrdiff_t i_base,
+		      const size_t width,
+		      const unsigned int log_arity,
+		      int (*compare)(const void *,
+				     const void *));
+
+void heapify_dary_bheap_nodes(char *const nodes,
+			      const size_t length,
+			      const size_t width,
+			      const size_t arity,
+			      int (*compare)(const void *,
+					     const void *));
+
+inline void heapify_bheap_nodes(char *const nodes,
+				const size_t length,
+				const size_t width,
+				int (*compare)(const void *,
+					       const void *))
+{
+	heapify_dary_bheap_nodes(nodes, length, width, BHEAP_ARITY, compare);
+}
+
+
+/* snapshot
+ ******************************************************************************/
+#define BHEAP_SNAPSHOT_MAGIC	  "BHEAPSNP"
+#define BHEAP_SNAPSHOT_VERSION	  1u
+#define BHEAP_SNAPSHOT_BYTE_ORDER 0x01020304u
+
+/* file header, followed (at 'offset', chosen so that 'nodes[2]' starts a cache
+ * line of the mapped file) by 'nodes[1 .. count]' exactly as held in memory */
+struct BHeapSnapshot {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;	/* BHEAP_SNAPSHOT_BYTE_ORDER as written */
+	uint64_t width;
+	uint64_t count;
+	uint32_t log_arity;
+	uint32_t shift_mode;
+	uint64_t offset;	/* of 'nodes[1]' */
+};
+
+/* flushes and writes a snapshot of 'heap' to 'fd' at its current position */
+void bheap_save(struct BHeap *heap,
+		const int fd);
+
+/* maps the snapshot at 'path' privately and returns it as a heap, without
+ * copying or re-heapifying: nodes are paged in as touched, and modified
+ * copy-on-write (the file is never written).  The first resize moves the nodes
+ * into memory from the heap's allocator and unmaps the file.  'compare' must
+ * order nodes as the saved heap's did.  Returns NULL if 'path' cannot be
+ * mapped or is not a snapshot this build can read. */
+struct BHeap *bheap_map(const char *const path,
+			int (*compare)(const void *,
+				       const void *));
+
 
 /* display
  ******************************************************************************/
@@ -118,11 +736,33 @@ void print_bheap(struct BHeap *heap,
 
 /* heapsort
  ******************************************************************************/
-void sort_bheap_nodes(void *const nodes,
-		      const size_t length,
-		      const size_t width,
-		      int (*compare)(const void *,
-				     const void *));
+/* sorts 1-based 'nodes' into extraction order (nodes[1] is the node that
+ * would be extracted first) through a heap of 2^'log_arity' children per node
+ * using 'shift_mode' */
+void do_bheap_sort(char *const nodes,
+		   const size_t length,
+		   const size_t width,
+		   const unsigned int log_arity,
+		   const enum BHeapShiftMode shift_mode,
+		   int (*compare)(const void *,
+				  const void *));
+
+/* as above, with an 'arity'-ary heap and BHEAP_SHIFT_MODE */
+void sort_dary_bheap_nodes(char *const nodes,
+			   const size_t length,
+			   const size_t width,
+			   const size_t arity,
+			   int (*compare)(const void *,
+					  const void *));
+
+inline void sort_bheap_nodes(char *const nodes,
+			     const size_t length,
+			     const size_t width,
+			     int (*compare)(const void *,
+					    const void *))
+{
+	sort_dary_bheap_nodes(nodes, length, width, BHEAP_ARITY, compare);
+}
 
 inline void bheap_sort(void *const array,
 		       const size_t length,
@@ -130,38 +770,44 @@ inline void bheap_sort(void *const array,
 		       int (*compare)(const void *,
 				      const void *))
 {
-	sort_bheap_nodes(&array[-1l], length, width, compare);
+	sort_bheap_nodes(((char *) array) - width, length, width, compare);
 }
 
 
 
 /* convienience, misc
  ******************************************************************************/
-inline struct BHeap *array_into_bheap(void *const array,
-				      const size_t length,
-				      const size_t width,
-				      int (*compare)(const void *,
-						     const void *))
+inline struct BHeap *array_into_dary_bheap(const void *const array,
+					   const size_t length,
+					   const size_t width,
+					   const size_t arity,
+					   int (*compare)(const void *,
+							  const void *))
 {
-	const size_t array_size = width * length;
-	struct BHeap *heap;
-	void *nodes;
+	struct BHeap *heap = init_sized_dary_bheap(width, length, arity,
+						   compare);
 
-	HANDLE_MALLOC(heap, sizeof(struct BHeap));
-	HANDLE_MALLOC(nodes, array_size);
-	memcpy(nodes, array, array_size);
+	memcpy(&heap->nodes[width], array, width * length);
 
-	/* sentinel node at index 0 */
-	--nodes;
+	do_bheap_heapify(heap->nodes, 1l, length, width, heap->log_arity,
+			 BHEAP_COMPARE(heap));
 
-	sort_bheap_nodes(nodes, width, length, compare);
+	BHEAP_STATS_DONE();
 
-	heap->nodes   = nodes;
-	heap->count   = length;
-	heap->alloc   = length;
-	heap->compare = compare;
+	heap->count = length;
+
+	bheap_stats_count(heap);
 
 	return heap;
+}
 
+inline struct BHeap *array_into_bheap(const void *const array,
+				      const size_t length,
+				      const size_t width,
+				      int (*compare)(const void *,
+						     const void *))
+{
+	return array_into_dary_bheap(array, length, width, BHEAP_ARITY,
+				     compare);
 }
 #endif /* ifndef BHEAP_BHEAP_H_ */
@@ -0,0 +1,288 @@
+#ifndef BHEAP_BHEAP_HPP_
+#define BHEAP_BHEAP_HPP_
+#include <cstddef>	/* std::size_t, std::ptrdiff_t */
+#include <functional>	/* std::less */
+#include <memory>	/* std::allocator, std::allocator_traits */
+#include <utility>	/* std::move, std::forward */
+
+/*			- bheap.hpp -
+ * header-only, type-specialized counterpart of 'struct BHeap'
+ *
+ * Same 1-based layout as the C heap ('nodes[0]' is a sentinel that is never
+ * dereferenced), but 'Compare' is inlined at every sift step and nodes are
+ * moved with T's move operations instead of 'memcpy' of a runtime width.
+ *
+ * 'compare(x, y)' returns true if 'x' belongs above 'y', so the default
+ * 'std::less<T>' yields a min-heap (the opposite of 'std::priority_queue').
+ * 'Compare' and 'Alloc' must be class types (function objects, allocators).
+ *
+ * 'top' and 'extract' must not be called on an empty heap.
+ */
+
+namespace bheap {
+
+template <typename T,
+	  typename Compare = std::less<T>,
+	  typename Alloc   = std::allocator<T> >
+class BHeap {
+public:
+	typedef T			value_type;
+	typedef std::size_t		size_type;
+	typedef Compare			value_compare;
+	typedef Alloc			allocator_type;
+
+	static const size_type DEFAULT_ALLOC = 16;
+
+	explicit BHeap(const Compare &compare = Compare(),
+		       const Alloc &alloc     = Alloc())
+		: impl(compare, alloc), count_(0), alloc_(0), nodes(nullptr)
+	{
+		reserve(DEFAULT_ALLOC);
+	}
+
+	BHeap(BHeap &&other) noexcept
+		: impl(std::move(other.impl)),
+		  count_(other.count_), alloc_(other.alloc_), nodes(other.nodes)
+	{
+		other.count_ = 0;
+		other.alloc_ = 0;
+		other.nodes  = nullptr;
+	}
+
+	BHeap(const BHeap &)		= delete;
+	BHeap &operator=(const BHeap &) = delete;
+
+	BHeap &operator=(BHeap &&other) noexcept
+	{
+		if (this != &other) {
+			release();
+			impl   = std::move(other.impl);
+			count_ = other.count_;
+			alloc_ = other.alloc_;
+			nodes  = other.nodes;
+			other.count_ = 0;
+			other.alloc_ = 0;
+			other.nodes  = nullptr;
+		}
+		return *this;
+	}
+
+	~BHeap()
+	{
+		release();
+	}
+
+	/* accessors
+	 **********************************************************************/
+	size_type count() const { return count_; }
+	size_type alloc() const { return alloc_; }
+	bool	  empty() const { return count_ == 0; }
+
+	const T &top() const { return nodes[1]; }
+
+	/* resize
+	 **********************************************************************/
+	void reserve(const size_type alloc)
+	{
+		if (alloc <= alloc_)
+			return;
+
+		T *const block = traits::allocate(impl, alloc);
+
+		for (size_type i = 1; i <= count_; ++i) {
+			traits::construct(impl, &block[i - 1],
+					  std::move_if_noexcept(nodes[i]));
+			traits::destroy(impl, &nodes[i]);
+		}
+
+		if (nodes != nullptr)
+			traits::deallocate(impl, &nodes[1], alloc_);
+
+		/* sentinel node at index 0 */
+		nodes  = block - 1;
+		alloc_ = alloc;
+	}
+
+	void clear()
+	{
+		for (size_type i = 1; i <= count_; ++i)
+			traits::destroy(impl, &nodes[i]);
+
+		count_ = 0;
+	}
+
+	/* insertion
+	 **********************************************************************/
+	void insert(const T &next)
+	{
+		emplace(next);
+	}
+
+	void insert(T &&next)
+	{
+		emplace(std::move(next));
+	}
+
+	template <typename... Args>
+	void emplace(Args &&... args)
+	{
+		/* a moved-from heap has nothing allocated */
+		if (count_ == alloc_)
+			reserve((alloc_ != 0) ? (alloc_ * 2) : DEFAULT_ALLOC);
+
+		++count_;
+
+		traits::construct(impl, &nodes[count_],
+				  std::forward<Args>(args)...);
+
+		do_insert(count_);
+	}
+
+	template <typename InputIt>
+	void insert_array(InputIt first, const InputIt last)
+	{
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	/* extraction
+	 **********************************************************************/
+	T extract()
+	{
+		T root(std::move(nodes[1]));
+
+		if (count_ > 1) {
+			T next(std::move(nodes[count_]));
+			traits::destroy(impl, &nodes[count_]);
+			--count_;
+			do_shift(std::move(next), 1);
+		} else {
+			traits::destroy(impl, &nodes[count_]);
+			--count_;
+		}
+
+		return root;
+	}
+
+	/* returns false and leaves 'out' untouched if the heap is empty */
+	bool extract(T &out)
+	{
+		if (count_ == 0)
+			return false;
+
+		out = extract();
+		return true;
+	}
+
+	/* replace-top, push-pop
+	 **********************************************************************/
+	/* overwrites the root with 'next' and shifts it down once */
+	void replace_top(T next)
+	{
+		if (count_ == 0)
+			insert(std::move(next));
+		else
+			do_shift(std::move(next), 1);
+	}
+
+	/* inserts 'next' and extracts the best node; 'next' itself comes
+	 * straight back after one comparison if it belongs above the root */
+	T pushpop(T next)
+	{
+		if ((count_ == 0) || !compare(nodes[1], next))
+			return next;
+
+		T root(std::move(nodes[1]));
+		do_shift(std::move(next), 1);
+
+		return root;
+	}
+
+private:
+	typedef std::allocator_traits<Alloc> traits;
+
+	/* empty base optimization for stateless comparators and allocators */
+	struct Impl : Compare, Alloc {
+		Impl(const Compare &compare, const Alloc &alloc)
+			: Compare(compare), Alloc(alloc) {}
+
+		Impl(Impl &&) = default;
+		Impl &operator=(Impl &&) = default;
+
+		bool operator()(const T &x, const T &y) const
+		{
+			return static_cast<const Compare &>(*this)(x, y);
+		}
+	} impl;
+
+	size_type count_;	/* count of occupied nodes */
+	size_type alloc_;	/* count of allocated nodes */
+	T *nodes;
+
+	void release()
+	{
+		if (nodes == nullptr)
+			return;
+
+		clear();
+		traits::deallocate(impl, &nodes[1], alloc_);
+		nodes = nullptr;
+	}
+
+	bool compare(const T &x, const T &y) const
+	{
+		return impl(x, y);
+	}
+
+	/* shift 'nodes[i_next]' up toward the root, moving parents down into
+	 * the hole it leaves
+	 **********************************************************************/
+	void do_insert(size_type i_next)
+	{
+		if (i_next == 1)
+			return;
+
+		T next(std::move(nodes[i_next]));
+
+		do {
+			const size_type i_parent = i_next / 2;
+
+			if (compare(nodes[i_parent], next))
+				break;
+
+			/* nodes[i_next] = parent; */
+			nodes[i_next] = std::move(nodes[i_parent]);
+			i_next	      = i_parent;
+		} while (i_next > 1);
+
+		nodes[i_next] = std::move(next);
+	}
+
+	/* shift 'next' down from the hole at 'i_next' to its place in the
+	 * first 'count_' nodes
+	 **********************************************************************/
+	void do_shift(T &&next, size_type i_next)
+	{
+		const size_type i_base = count_;
+		size_type i_child;
+
+		while ((i_child = i_next * 2) <= i_base) {
+			/* select the child that belongs above its sibling */
+			if ((i_child < i_base)
+			    && compare(nodes[i_child + 1], nodes[i_child]))
+				++i_child;
+
+			if (!compare(nodes[i_child], next))
+				break;
+
+			/* nodes[i_next] = child; */
+			nodes[i_next] = std::move(nodes[i_child]);
+			i_next	      = i_child;
+		}
+
+		nodes[i_next] = std::move(next);
+	}
+};
+
+} /* namespace bheap */
+#endif /* ifndef BHEAP_BHEAP_HPP_ */
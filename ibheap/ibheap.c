@@ -0,0 +1,238 @@
+#include <ibheap/ibheap.h>
+
+/* initialize, destroy, resize
+ ******************************************************************************/
+extern inline struct IBHeap *init_sized_dary_ibheap(const size_t width,
+						    const size_t size,
+						    const size_t arity,
+						    int (*compare)(const void *,
+								   const void *));
+
+extern inline struct IBHeap *init_ibheap(const size_t width,
+					 int (*compare)(const void *,
+							const void *));
+
+extern inline void clear_ibheap(struct IBHeap *heap);
+
+extern inline void free_ibheap(struct IBHeap *heap);
+
+void realloc_ibheap(struct IBHeap *heap,
+		    const size_t alloc)
+{
+	size_t *handles = &heap->handles[1l];
+
+	HANDLE_REALLOC(handles,		   sizeof(size_t) * alloc);
+	HANDLE_REALLOC(heap->positions,	   sizeof(size_t) * alloc);
+	HANDLE_REALLOC(heap->free_handles, sizeof(size_t) * alloc);
+	HANDLE_REALLOC(heap->slab,	   heap->width * alloc);
+
+	heap->handles = handles - 1l;
+	heap->alloc   = alloc;
+}
+
+
+/* accessors
+ ******************************************************************************/
+extern inline void *ibheap_node(const struct IBHeap *heap,
+				const size_t handle);
+
+extern inline bool ibheap_contains(const struct IBHeap *heap,
+				   const size_t handle);
+
+extern inline size_t ibheap_peek(const struct IBHeap *heap);
+
+
+/* shift 'handle' up from 'i_next' / down from 'i_next', keeping 'positions'
+ * in step with every handle moved
+ ******************************************************************************/
+static void do_ibheap_shift_up(struct IBHeap *heap,
+			       const size_t handle,
+			       ptrdiff_t i_next)
+{
+	size_t *const handles	= heap->handles;
+	size_t *const positions = heap->positions;
+	const unsigned int log_arity = heap->log_arity;
+	const void *const next = ibheap_node(heap, handle);
+	int (*compare)(const void *,
+		       const void *) = heap->compare;
+	ptrdiff_t i_parent;
+	size_t parent;
+
+	while (i_next > 1l) {
+		i_parent = bheap_i_parent(i_next, log_arity);
+		parent	 = handles[i_parent];
+
+		if (compare(ibheap_node(heap, parent), next))
+			break;
+
+		/* nodes[i_next] = parent; */
+		handles[i_next]	  = parent;
+		positions[parent] = i_next;
+		i_next		  = i_parent;
+	}
+
+	handles[i_next]	  = handle;
+	positions[handle] = i_next;
+}
+
+static void do_ibheap_shift_down(struct IBHeap *heap,
+				 const size_t handle,
+				 ptrdiff_t i_next)
+{
+	size_t *const handles	= heap->handles;
+	size_t *const positions = heap->positions;
+	const ptrdiff_t i_base	= heap->count;
+	const unsigned int log_arity = heap->log_arity;
+	const void *const next = ibheap_node(heap, handle);
+	int (*compare)(const void *,
+		       const void *) = heap->compare;
+	ptrdiff_t i_child, i_last, i_top;
+	size_t top;
+
+	while ((i_child = bheap_i_child(i_next, log_arity)) <= i_base) {
+		i_last = i_child + (1l << log_arity) - 1l;
+
+		if (i_last > i_base)
+			i_last = i_base;
+
+		/* find the child that belongs above all of its siblings */
+		i_top = i_child;
+		top   = handles[i_top];
+
+		while (i_child < i_last) {
+			++i_child;
+
+			if (compare(ibheap_node(heap, handles[i_child]),
+				    ibheap_node(heap, top))) {
+				i_top = i_child;
+				top   = handles[i_top];
+			}
+		}
+
+		/* 'next' belongs above all children */
+		if (!compare(ibheap_node(heap, top), next))
+			break;
+
+		/* nodes[i_next] = top; */
+		handles[i_next] = top;
+		positions[top]	= i_next;
+		i_next		= i_top;
+	}
+
+	handles[i_next]	  = handle;
+	positions[handle] = i_next;
+}
+
+static inline void release_handle(struct IBHeap *heap,
+				  const size_t handle)
+{
+	heap->positions[handle] = 0ul;
+	heap->free_handles[heap->count_free] = handle;
+	++(heap->count_free);
+}
+
+/* shifts the node at 'handle' up or down from its position as needed */
+static void reposition(struct IBHeap *heap,
+		       const size_t handle)
+{
+	const ptrdiff_t i_node = heap->positions[handle];
+
+	if (i_node > 1l) {
+		const ptrdiff_t i_parent = bheap_i_parent(i_node,
+							  heap->log_arity);
+
+		/* node now belongs above its parent (decrease-key) */
+		if (!heap->compare(ibheap_node(heap, heap->handles[i_parent]),
+				   ibheap_node(heap, handle))) {
+			do_ibheap_shift_up(heap, handle, i_node);
+			return;
+		}
+	}
+
+	do_ibheap_shift_down(heap, handle, i_node);
+}
+
+/* fills the hole left at 'i_hole' by the departing node with the base node
+ * ('count' already excludes the base, so it is repositioned unchecked) */
+static inline void fill_hole(struct IBHeap *heap,
+			     const ptrdiff_t i_hole)
+{
+	const size_t base = heap->handles[heap->count];
+
+	--(heap->count);
+
+	if (i_hole > (ptrdiff_t) heap->count)
+		return;
+
+	heap->positions[base] = i_hole;
+	reposition(heap, base);
+}
+
+
+/* insertion
+ ******************************************************************************/
+size_t ibheap_insert(struct IBHeap *heap,
+		     const void *const next)
+{
+	size_t handle;
+
+	if (heap->count_free > 0ul) {
+		--(heap->count_free);
+		handle = heap->free_handles[heap->count_free];
+
+	} else {
+		if (heap->count == heap->alloc)
+			realloc_ibheap(heap, heap->alloc * 2ul);
+
+		handle = heap->count;
+	}
+
+	memcpy(ibheap_node(heap, handle), next, heap->width);
+
+	++(heap->count);
+
+	do_ibheap_shift_up(heap, handle, heap->count);
+
+	return handle;
+}
+
+
+/* extraction
+ ******************************************************************************/
+void *ibheap_extract(struct IBHeap *heap)
+{
+	if (heap->count == 0ul)
+		return NULL;
+
+	const size_t root = heap->handles[1l];
+
+	fill_hole(heap, 1l);
+	release_handle(heap, root);
+
+	return ibheap_node(heap, root);
+}
+
+
+/* priority changes, removal
+ ******************************************************************************/
+void ibheap_update(struct IBHeap *heap,
+		   const size_t handle)
+{
+	if (ibheap_contains(heap, handle))
+		reposition(heap, handle);
+}
+
+extern inline void ibheap_replace(struct IBHeap *heap,
+				  const size_t handle,
+				  const void *const next);
+
+void ibheap_remove(struct IBHeap *heap,
+		   const size_t handle)
+{
+	/* position 0 would fill the sentinel */
+	if (!ibheap_contains(heap, handle))
+		return;
+
+	fill_hole(heap, heap->positions[handle]);
+	release_handle(heap, handle);
+}
@@ -0,0 +1,150 @@
+#ifndef IBHEAP_IBHEAP_H_
+#define IBHEAP_IBHEAP_H_
+#include <stdbool.h>		/* bool */
+#include <utils/utils.h>	/* HANDLE_MALLOC, HANDLE_REALLOC */
+#include <bheap/bheap.h>	/* d-ary index math, BHEAP_ARITY */
+
+/*			- ibheap.h -
+ * indexed (addressable) d-ary heap
+ *
+ * Nodes live in a stable slab and are named by the handle returned from
+ * 'ibheap_insert'.  The heap proper is a 1-based array of handles, and a
+ * position map from handle to heap index lets 'ibheap_update' and
+ * 'ibheap_remove' reach any node in O(log n) -- no duplicate entries are
+ * needed to change a node's priority.
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ */
+
+#define IBHEAP_NULL_HANDLE ((size_t) -1)
+
+struct IBHeap {
+	size_t count;		/* count of occupied nodes */
+	size_t alloc;		/* count of allocated nodes */
+	size_t width;		/* byte size per node */
+	size_t count_free;	/* count of released handles */
+	unsigned int log_arity;	/* log2 of children per node */
+	size_t *handles;	/* 1-based heap of handles */
+	size_t *positions;	/* positions[handle] = heap index, 0 if free */
+	size_t *free_handles;	/* stack of released handles */
+	char *slab;		/* slab[handle * width] = node */
+	int (*compare)(const void *,
+		       const void *);
+};
+
+/* initialize, destroy, resize
+ ******************************************************************************/
+inline struct IBHeap *init_sized_dary_ibheap(const size_t width,
+					     const size_t size,
+					     const size_t arity,
+					     int (*compare)(const void *,
+							    const void *))
+{
+	/* growth doubles 'alloc', which must not start at 0 */
+	const size_t alloc = (size == 0ul) ? BHEAP_DEFAULT_ALLOC : size;
+	struct IBHeap *heap;
+
+	HANDLE_MALLOC(heap, sizeof(struct IBHeap));
+	HANDLE_MALLOC(heap->handles,	  sizeof(size_t) * alloc);
+	HANDLE_MALLOC(heap->positions,	  sizeof(size_t) * alloc);
+	HANDLE_MALLOC(heap->free_handles, sizeof(size_t) * alloc);
+	HANDLE_MALLOC(heap->slab,	  width * alloc);
+
+	/* sentinel handle at index 0 */
+	--(heap->handles);
+
+	heap->count	 = 0ul;
+	heap->alloc	 = alloc;
+	heap->width	 = width;
+	heap->count_free = 0ul;
+	heap->log_arity  = bheap_log_arity(arity);
+	heap->compare	 = compare;
+
+	return heap;
+}
+
+inline struct IBHeap *init_ibheap(const size_t width,
+				  int (*compare)(const void *,
+						 const void *))
+{
+	return init_sized_dary_ibheap(width, BHEAP_DEFAULT_ALLOC, BHEAP_ARITY,
+				      compare);
+}
+
+inline void clear_ibheap(struct IBHeap *heap)
+{
+	heap->count	 = 0ul;
+	heap->count_free = 0ul;
+}
+
+inline void free_ibheap(struct IBHeap *heap)
+{
+	free(&heap->handles[1l]);
+	free(heap->positions);
+	free(heap->free_handles);
+	free(heap->slab);
+	free(heap);
+}
+
+void realloc_ibheap(struct IBHeap *heap,
+		    const size_t alloc);
+
+
+/* accessors
+ ******************************************************************************/
+/* node named by 'handle', stable until 'handle' is extracted or removed */
+inline void *ibheap_node(const struct IBHeap *heap,
+			 const size_t handle)
+{
+	return &heap->slab[handle * heap->width];
+}
+
+inline bool ibheap_contains(const struct IBHeap *heap,
+			    const size_t handle)
+{
+	return (handle < (heap->count + heap->count_free))
+	    && (heap->positions[handle] != 0ul);
+}
+
+/* handle of the root, IBHEAP_NULL_HANDLE if empty */
+inline size_t ibheap_peek(const struct IBHeap *heap)
+{
+	return (heap->count == 0ul) ? IBHEAP_NULL_HANDLE : heap->handles[1l];
+}
+
+
+/* insertion
+ ******************************************************************************/
+/* copies 'next' into the slab and returns its handle */
+size_t ibheap_insert(struct IBHeap *heap,
+		     const void *const next);
+
+
+/* extraction
+ ******************************************************************************/
+/* returns a pointer to the extracted node, valid until the next insertion */
+void *ibheap_extract(struct IBHeap *heap);
+
+
+/* priority changes, removal
+ ******************************************************************************/
+/* restores heap order after the node at 'handle' has been modified in place
+ * (through 'ibheap_node') -- covers both decrease-key and increase-key, no-op
+ * if 'handle' is not in 'heap' */
+void ibheap_update(struct IBHeap *heap,
+		   const size_t handle);
+
+/* overwrites the node at 'handle' with 'next' and restores heap order */
+inline void ibheap_replace(struct IBHeap *heap,
+			   const size_t handle,
+			   const void *const next)
+{
+	memcpy(ibheap_node(heap, handle), next, heap->width);
+	ibheap_update(heap, handle);
+}
+
+/* removes the node at 'handle' and releases 'handle', no-op if 'handle' is
+ * not in 'heap' (released or never handed out) */
+void ibheap_remove(struct IBHeap *heap,
+		   const size_t handle);
+#endif /* ifndef IBHEAP_IBHEAP_H_ */
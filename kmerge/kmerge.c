@@ -0,0 +1,184 @@
+#include <kmerge/kmerge.h>
+
+static int compare_cursor(const void *x,
+			  const void *y)
+{
+	const struct KMergeCursor *const cx = (const struct KMergeCursor *) x;
+
+	return cx->compare(cx->head, ((const struct KMergeCursor *) y)->head);
+}
+
+/* points 'cursor' at the next batch of its run, returning false if the run is
+ * exhausted */
+static bool refill(struct KMerge *merge,
+		   struct KMergeCursor *cursor)
+{
+	struct KMergeRun *const run = &merge->runs[cursor->i_run];
+	size_t count;
+
+	if (run->read == NULL)
+		return false;
+
+	count = run->read(run->context, run->buffer, run->capacity);
+
+	if (count > run->capacity)
+		EXIT_ON_FAILURE("read callback returned %lu nodes, capacity %lu",
+				count, run->capacity);
+
+	cursor->head = run->buffer;
+	cursor->end  = &run->buffer[count * merge->width];
+
+	return count > 0ul;
+}
+
+static size_t add_run(struct KMerge *merge)
+{
+	if (merge->count_runs == merge->alloc_runs) {
+		merge->alloc_runs *= 2ul;
+		HANDLE_REALLOC(merge->runs,
+			       sizeof(struct KMergeRun) * merge->alloc_runs);
+	}
+
+	return (merge->count_runs)++;
+}
+
+static void enter_cursor(struct KMerge *merge,
+			 struct KMergeCursor *cursor)
+{
+	if (cursor->head < cursor->end)
+		bheap_insert(merge->tournament, cursor);
+}
+
+
+/* initialize, destroy
+ ******************************************************************************/
+struct KMerge *init_kmerge(const size_t width,
+			   int (*compare)(const void *,
+					  const void *))
+{
+	struct KMerge *merge;
+
+	HANDLE_MALLOC(merge, sizeof(struct KMerge));
+	HANDLE_MALLOC(merge->runs,
+		      sizeof(struct KMergeRun) * BHEAP_DEFAULT_ALLOC);
+
+	merge->width	  = width;
+	merge->count_runs = 0ul;
+	merge->alloc_runs = BHEAP_DEFAULT_ALLOC;
+	merge->compare	  = compare;
+
+	/* binary: a replaced head most often stays near the root */
+	merge->tournament = init_dary_bheap(sizeof(struct KMergeCursor), 2ul,
+					    &compare_cursor);
+
+	return merge;
+}
+
+void free_kmerge(struct KMerge *merge)
+{
+	for (size_t i = 0ul; i < merge->count_runs; ++i)
+		free(merge->runs[i].buffer);
+
+	free(merge->runs);
+	free_bheap(merge->tournament);
+	free(merge);
+}
+
+
+/* runs
+ ******************************************************************************/
+void kmerge_add_buffer(struct KMerge *merge,
+		       const void *const nodes,
+		       const size_t length)
+{
+	const size_t i_run = add_run(merge);
+	struct KMergeCursor cursor = {
+		.head	 = (const char *) nodes,
+		.end	 = ((const char *) nodes) + (length * merge->width),
+		.i_run	 = i_run,
+		.compare = merge->compare
+	};
+
+	merge->runs[i_run].read	    = NULL;
+	merge->runs[i_run].context  = NULL;
+	merge->runs[i_run].buffer   = NULL;
+	merge->runs[i_run].capacity = length;
+
+	enter_cursor(merge, &cursor);
+}
+
+void kmerge_add_reader(struct KMerge *merge,
+		       KMergeRead read,
+		       void *context,
+		       const size_t capacity)
+{
+	const size_t i_run = add_run(merge);
+	struct KMergeCursor cursor = {
+		.i_run	 = i_run,
+		.compare = merge->compare
+	};
+	struct KMergeRun *const run = &merge->runs[i_run];
+
+	run->read     = read;
+	run->context  = context;
+	run->capacity = (capacity == 0ul) ? 1ul : capacity;
+
+	HANDLE_MALLOC(run->buffer, merge->width * run->capacity);
+
+	if (refill(merge, &cursor))
+		enter_cursor(merge, &cursor);
+}
+
+
+/* output
+ ******************************************************************************/
+size_t kmerge_next(struct KMerge *merge,
+		   void *const out,
+		   const size_t capacity)
+{
+	struct BHeap *const tournament = merge->tournament;
+	const size_t width = merge->width;
+	char *next	   = (char *) out;
+	char *const end	   = next + (capacity * width);
+	struct KMergeCursor *top, cursor;
+	size_t length;
+
+	while ((next < end) && (tournament->count > 0ul)) {
+		top = (struct KMergeCursor *) &tournament->nodes[tournament->width];
+
+		/* last run standing: copy its batch straight through */
+		if (tournament->count == 1ul) {
+			length = top->end - top->head;
+
+			if (length > (size_t) (end - next))
+				length = end - next;
+
+			memcpy(next, top->head, length);
+			next	  += length;
+			top->head += length;
+
+		} else {
+			memcpy(next, top->head, width);
+			next	  += width;
+			top->head += width;
+		}
+
+		if (top->head < top->end) {
+			if (tournament->count > 1ul) {
+				cursor = *top;
+				bheap_replace_top(tournament, &cursor);
+			}
+
+			continue;
+		}
+
+		cursor = *top;
+
+		if (refill(merge, &cursor))
+			bheap_replace_top(tournament, &cursor);
+		else
+			(void) bheap_extract(tournament);
+	}
+
+	return (next - ((char *) out)) / width;
+}
@@ -0,0 +1,85 @@
+#ifndef KMERGE_KMERGE_H_
+#define KMERGE_KMERGE_H_
+#include <stdbool.h>		/* bool */
+#include <utils/utils.h>	/* HANDLE_MALLOC, HANDLE_REALLOC */
+#include <bheap/bheap.h>	/* struct BHeap, bheap_replace_top */
+
+/*			- kmerge.h -
+ * streaming k-way merge of sorted runs
+ *
+ * Each run is read through a cursor: either a caller buffer merged in place,
+ * or a buffer of the merge's own refilled by a caller read callback.  A
+ * tournament 'struct BHeap' holds one cursor per unexhausted run, ordered by
+ * its head node; emitting a node advances the winning cursor and shifts it
+ * back down from the root (replace-top), so each node is copied exactly once,
+ * straight from its run into the caller's output buffer.
+ *
+ * Runs must each be in extraction order.  The merge is not stable across
+ * runs.
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ */
+
+/* fills 'buffer' with up to 'capacity' nodes of the run named by 'context' and
+ * returns the count written, 0 once the run is exhausted */
+typedef size_t (*KMergeRead)(void *context,
+			     void *buffer,
+			     const size_t capacity);
+
+struct KMergeRun {
+	KMergeRead read;	/* NULL for caller buffers */
+	void *context;
+	char *buffer;		/* owned when 'read' is set */
+	size_t capacity;	/* nodes per refill */
+};
+
+/* tournament node */
+struct KMergeCursor {
+	const char *head;
+	const char *end;
+	size_t i_run;
+	int (*compare)(const void *,
+		       const void *);
+};
+
+struct KMerge {
+	size_t width;		/* byte size per node */
+	size_t count_runs;
+	size_t alloc_runs;
+	struct KMergeRun *runs;
+	struct BHeap *tournament;	/* of 'struct KMergeCursor' */
+	int (*compare)(const void *,
+		       const void *);
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+struct KMerge *init_kmerge(const size_t width,
+			   int (*compare)(const void *,
+					  const void *));
+
+void free_kmerge(struct KMerge *merge);
+
+
+/* runs (may be added at any time; nodes already emitted are not revisited)
+ ******************************************************************************/
+/* merges 'length' nodes at 'nodes' in place; they must outlive the merge */
+void kmerge_add_buffer(struct KMerge *merge,
+		       const void *const nodes,
+		       const size_t length);
+
+/* merges the nodes produced by 'read(context, ...)', 'capacity' at a time */
+void kmerge_add_reader(struct KMerge *merge,
+		       KMergeRead read,
+		       void *context,
+		       const size_t capacity);
+
+
+/* output
+ ******************************************************************************/
+/* writes up to 'capacity' merged nodes to 'out', returning the count written
+ * (less than 'capacity' only once every run is exhausted) */
+size_t kmerge_next(struct KMerge *merge,
+		   void *const out,
+		   const size_t capacity);
+#endif /* ifndef KMERGE_KMERGE_H_ */
@@ -0,0 +1,105 @@
+#include <kpheap/kpheap.h>
+
+extern inline size_t kpheap_index_offset(const size_t key_width);
+
+extern inline size_t kpheap_node_width(const size_t key_width);
+
+
+/* initialize, destroy, resize
+ ******************************************************************************/
+extern inline struct KPHeap *init_sized_dary_kpheap(const size_t key_width,
+						    const size_t payload_width,
+						    const size_t size,
+						    const size_t arity,
+						    int (*compare)(const void *,
+								   const void *));
+
+extern inline struct KPHeap *init_kpheap(const size_t key_width,
+					 const size_t payload_width,
+					 int (*compare)(const void *,
+							const void *));
+
+extern inline void clear_kpheap(struct KPHeap *heap);
+
+extern inline void free_kpheap(struct KPHeap *heap);
+
+void realloc_kpheap_slab(struct KPHeap *heap,
+			 const size_t alloc)
+{
+	if (alloc > (((size_t) UINT32_MAX) + 1ul))
+		EXIT_ON_FAILURE("payload slots (%lu) exceed 32-bit indices",
+				alloc);
+
+	HANDLE_REALLOC(heap->free_slots, sizeof(uint32_t) * alloc);
+	HANDLE_REALLOC(heap->slab,	 heap->payload_width * alloc);
+
+	heap->alloc_slots = alloc;
+}
+
+
+/* accessors
+ ******************************************************************************/
+extern inline size_t kpheap_count(const struct KPHeap *heap);
+
+extern inline const void *kpheap_peek_key(const struct KPHeap *heap);
+
+extern inline const void *kpheap_peek_payload(const struct KPHeap *heap);
+
+
+/* insertion
+ ******************************************************************************/
+void kpheap_insert(struct KPHeap *heap,
+		   const void *const key,
+		   const void *const payload)
+{
+	char node[heap->heap->width];
+	uint32_t index;
+
+	if (heap->count_free > 0ul) {
+		--(heap->count_free);
+		index = heap->free_slots[heap->count_free];
+
+	} else {
+		if (heap->count_slots == heap->alloc_slots)
+			realloc_kpheap_slab(heap, heap->alloc_slots * 2ul);
+
+		index = (uint32_t) heap->count_slots;
+		++(heap->count_slots);
+	}
+
+	memcpy(&heap->slab[index * heap->payload_width], payload,
+	       heap->payload_width);
+
+	memcpy(&node[0l], key, heap->key_width);
+	memcpy(&node[heap->index_offset], &index, sizeof(uint32_t));
+
+	bheap_insert(heap->heap, &node[0l]);
+}
+
+
+/* extraction
+ ******************************************************************************/
+bool kpheap_extract(struct KPHeap *heap,
+		    void *const key,
+		    void *const payload)
+{
+	if (heap->heap->count == 0ul)
+		return false;
+
+	const char *const node = (const char *) bheap_extract(heap->heap);
+	uint32_t index;
+
+	memcpy(&index, &node[heap->index_offset], sizeof(uint32_t));
+
+	if (key != NULL)
+		memcpy(key, node, heap->key_width);
+
+	if (payload != NULL)
+		memcpy(payload, &heap->slab[index * heap->payload_width],
+		       heap->payload_width);
+
+	heap->free_slots[heap->count_free] = index;
+	++(heap->count_free);
+
+	return true;
+}
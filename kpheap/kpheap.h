@@ -0,0 +1,151 @@
+#ifndef KPHEAP_KPHEAP_H_
+#define KPHEAP_KPHEAP_H_
+#include <stdbool.h>		/* bool */
+#include <stdint.h>		/* uint32_t */
+#include <utils/utils.h>	/* HANDLE_MALLOC, HANDLE_REALLOC */
+#include <bheap/bheap.h>	/* struct BHeap */
+
+/*			- kpheap.h -
+ * key/payload split heap for wide records
+ *
+ * The heap array ('struct BHeap') holds only a small fixed-width key and a
+ * 32-bit payload index per node, so shifts move a few bytes instead of whole
+ * records.  Payloads sit in a separate slab at stable indices, written once
+ * on insertion and copied out once on extraction.
+ *
+ * 'compare(x, y)' takes two KEYS and returns nonzero if key 'x' belongs above
+ * key 'y'
+ */
+
+/* byte offset of the payload index within a heap node */
+inline size_t kpheap_index_offset(const size_t key_width)
+{
+	return (key_width + (sizeof(uint32_t) - 1ul))
+	     & ~(sizeof(uint32_t) - 1ul);
+}
+
+/* heap node width: key, payload index, padded to keep keys of 8 bytes or
+ * more 8-byte aligned */
+inline size_t kpheap_node_width(const size_t key_width)
+{
+	const size_t align = (key_width >= 8ul) ? 8ul : sizeof(uint32_t);
+
+	return (kpheap_index_offset(key_width) + sizeof(uint32_t) + align - 1ul)
+	     & ~(align - 1ul);
+}
+
+struct KPHeap {
+	struct BHeap *heap;	/* nodes of (key, payload index) */
+	size_t key_width;	/* byte size per key */
+	size_t payload_width;	/* byte size per payload */
+	size_t index_offset;	/* kpheap_index_offset(key_width) */
+	size_t count_slots;	/* count of payload slots handed out */
+	size_t alloc_slots;	/* count of allocated payload slots */
+	size_t count_free;	/* count of released payload slots */
+	uint32_t *free_slots;	/* stack of released payload slots */
+	char *slab;		/* slab[index * payload_width] = payload */
+};
+
+/* initialize, destroy, resize
+ ******************************************************************************/
+inline struct KPHeap *init_sized_dary_kpheap(const size_t key_width,
+					     const size_t payload_width,
+					     const size_t size,
+					     const size_t arity,
+					     int (*compare)(const void *,
+							    const void *))
+{
+	struct KPHeap *heap;
+
+	HANDLE_MALLOC(heap, sizeof(struct KPHeap));
+	HANDLE_MALLOC(heap->free_slots, sizeof(uint32_t) * size);
+	HANDLE_MALLOC(heap->slab,	payload_width * size);
+
+	/* key leads the node, so 'compare' works on nodes unchanged */
+	heap->heap = init_sized_dary_bheap(kpheap_node_width(key_width), size,
+					   arity, compare);
+
+	heap->key_width	    = key_width;
+	heap->payload_width = payload_width;
+	heap->index_offset  = kpheap_index_offset(key_width);
+	heap->count_slots   = 0ul;
+	heap->alloc_slots   = size;
+	heap->count_free    = 0ul;
+
+	return heap;
+}
+
+inline struct KPHeap *init_kpheap(const size_t key_width,
+				  const size_t payload_width,
+				  int (*compare)(const void *,
+						 const void *))
+{
+	return init_sized_dary_kpheap(key_width, payload_width,
+				      BHEAP_DEFAULT_ALLOC, BHEAP_ARITY,
+				      compare);
+}
+
+inline void clear_kpheap(struct KPHeap *heap)
+{
+	clear_bheap(heap->heap);
+	heap->count_slots = 0ul;
+	heap->count_free  = 0ul;
+}
+
+inline void free_kpheap(struct KPHeap *heap)
+{
+	free_bheap(heap->heap);
+	free(heap->free_slots);
+	free(heap->slab);
+	free(heap);
+}
+
+void realloc_kpheap_slab(struct KPHeap *heap,
+			 const size_t alloc);
+
+
+/* accessors
+ ******************************************************************************/
+inline size_t kpheap_count(const struct KPHeap *heap)
+{
+	return heap->heap->count;
+}
+
+/* key of the root, NULL if empty */
+inline const void *kpheap_peek_key(const struct KPHeap *heap)
+{
+	return (heap->heap->count == 0ul)
+	     ? NULL
+	     : &heap->heap->nodes[heap->heap->width];
+}
+
+/* payload of the root (in place, no copy), NULL if empty */
+inline const void *kpheap_peek_payload(const struct KPHeap *heap)
+{
+	if (heap->heap->count == 0ul)
+		return NULL;
+
+	const uint32_t index = *((const uint32_t *)
+				 &heap->heap->nodes[heap->heap->width
+						    + heap->index_offset]);
+
+	return &heap->slab[index * heap->payload_width];
+}
+
+
+/* insertion
+ ******************************************************************************/
+/* copies 'key' into the heap and 'payload' into the slab */
+void kpheap_insert(struct KPHeap *heap,
+		   const void *const key,
+		   const void *const payload);
+
+
+/* extraction
+ ******************************************************************************/
+/* copies the root's key into 'key' and its payload into 'payload' (either may
+ * be NULL to skip it) and returns true, or returns false if empty */
+bool kpheap_extract(struct KPHeap *heap,
+		    void *const key,
+		    void *const payload);
+#endif /* ifndef KPHEAP_KPHEAP_H_ */
@@ -0,0 +1,283 @@
+#include <mmheap/mmheap.h>
+
+/* levels
+ ******************************************************************************/
+/* odd depth */
+static inline bool is_max_level(const size_t i_node)
+{
+	return ((BIT_SIZE(size_t) - 1u - __builtin_clzl(i_node)) & 1u) != 0u;
+}
+
+/* nonzero if 'x' belongs above 'y' on a level of kind 'max' */
+static inline int belongs(int (*compare)(const void *,
+					 const void *),
+			  const void *const x,
+			  const void *const y,
+			  const bool max)
+{
+	return max ? compare(y, x) : compare(x, y);
+}
+
+
+/* shift up, trickle down
+ ******************************************************************************/
+/* hangs 'next' at 'i_next' or above: past the parent if it belongs on the
+ * other kind of level, then up through grandparents of its own kind */
+static void push_up(char *const nodes,
+		    const void *const next,
+		    const size_t width,
+		    size_t i_next,
+		    int (*compare)(const void *,
+				   const void *))
+{
+	bool max = is_max_level(i_next);
+	size_t i_parent;
+
+	if (i_next > 1ul) {
+		i_parent = i_next >> 1;
+
+		if (belongs(compare, next, &nodes[i_parent * width], !max)) {
+			memcpy(&nodes[i_next * width],
+			       &nodes[i_parent * width],
+			       width);
+			i_next = i_parent;
+			max    = !max;
+		}
+	}
+
+	while (i_next > 3ul) {
+		i_parent = i_next >> 2;
+
+		if (!belongs(compare, next, &nodes[i_parent * width], max))
+			break;
+
+		memcpy(&nodes[i_next * width], &nodes[i_parent * width], width);
+		i_next = i_parent;
+	}
+
+	memcpy(&nodes[i_next * width], next, width);
+}
+
+/* hangs 'next' (a scratch copy, which may be swapped along the way) at
+ * 'i_next' or below among nodes 1 through 'i_base'.  A node of the same
+ * kind is always found among the grandchildren; a child can only lead when
+ * it has no children of its own. */
+static void trickle_down(char *const nodes,
+			 char *const next,
+			 const size_t width,
+			 size_t i_next,
+			 const size_t i_base,
+			 int (*compare)(const void *,
+					const void *))
+{
+	const bool max = is_max_level(i_next);
+	size_t i_child, i_grand, i_last, i_top;
+
+	while ((i_child = i_next << 1) <= i_base) {
+		i_grand = i_next << 2;
+
+		if (i_grand > i_base) {
+			/* children only, both leaves */
+			i_top = i_child;
+
+			if ((i_child < i_base)
+			    && belongs(compare,
+				       &nodes[(i_child + 1ul) * width],
+				       &nodes[i_child * width],
+				       max))
+				i_top = i_child + 1ul;
+
+			if (belongs(compare, &nodes[i_top * width], next, max)) {
+				memcpy(&nodes[i_next * width],
+				       &nodes[i_top * width],
+				       width);
+				i_next = i_top;
+			}
+
+			break;
+		}
+
+		i_last = (i_grand + 3ul < i_base) ? (i_grand + 3ul) : i_base;
+		i_top  = i_grand;
+
+		for (size_t i = i_grand + 1ul; i <= i_last; ++i)
+			if (belongs(compare, &nodes[i * width],
+				    &nodes[i_top * width], max))
+				i_top = i;
+
+		/* second child is a leaf */
+		if ((i_last < i_grand + 2ul) && (i_child < i_base)
+		    && belongs(compare,
+			       &nodes[(i_child + 1ul) * width],
+			       &nodes[i_top * width],
+			       max)) {
+			if (belongs(compare, &nodes[(i_child + 1ul) * width],
+				    next, max)) {
+				memcpy(&nodes[i_next * width],
+				       &nodes[(i_child + 1ul) * width],
+				       width);
+				i_next = i_child + 1ul;
+			}
+
+			break;
+		}
+
+		if (!belongs(compare, &nodes[i_top * width], next, max))
+			break;
+
+		memcpy(&nodes[i_next * width], &nodes[i_top * width], width);
+		i_next = i_top;
+
+		/* 'next' may now belong on the parent's kind of level */
+		if (belongs(compare, &nodes[(i_next >> 1) * width], next, max))
+			mem_swap(&nodes[(i_next >> 1) * width], next, width);
+	}
+
+	memcpy(&nodes[i_next * width], next, width);
+}
+
+
+/* initialize, destroy
+ ******************************************************************************/
+struct MMHeap *init_sized_mmheap(const size_t width,
+				 const size_t size,
+				 int (*compare)(const void *,
+						const void *))
+{
+	struct MMHeap *heap;
+
+	HANDLE_MALLOC(heap, sizeof(struct MMHeap));
+
+	heap->heap = init_sized_dary_bheap(width, size, 2ul, compare);
+
+	return heap;
+}
+
+extern inline struct MMHeap *init_mmheap(const size_t width,
+					 int (*compare)(const void *,
+							const void *));
+
+extern inline void clear_mmheap(struct MMHeap *heap);
+
+extern inline void free_mmheap(struct MMHeap *heap);
+
+
+/* accessors
+ ******************************************************************************/
+extern inline size_t mmheap_count(const struct MMHeap *heap);
+
+extern inline size_t mmheap_i_max(const struct MMHeap *heap);
+
+extern inline const void *mmheap_peek_min(const struct MMHeap *heap);
+
+extern inline const void *mmheap_peek_max(const struct MMHeap *heap);
+
+
+/* insertion
+ ******************************************************************************/
+void mmheap_insert(struct MMHeap *heap,
+		   const void *const next)
+{
+	struct BHeap *const nodes = heap->heap;
+
+	++(nodes->count);
+
+	if (nodes->count > nodes->alloc)
+		realloc_bheap(nodes, nodes->alloc * 2ul);
+
+	push_up(nodes->nodes, next, nodes->width, nodes->count,
+		nodes->compare);
+}
+
+void mmheap_insert_array(struct MMHeap *heap,
+			 const void *const array,
+			 const size_t length)
+{
+	struct BHeap *const storage = heap->heap;
+	const size_t count	    = storage->count;
+	const size_t width	    = storage->width;
+	const size_t next_count	    = count + length;
+
+	if (storage->alloc < next_count)
+		realloc_bheap(storage, next_pow_two(next_count));
+
+	char *const nodes      = storage->nodes;
+	const char *const from = (const char *) array;
+	char next[width];
+
+	/* bulk load: append and rebuild every level bottom up */
+	if ((length * BHEAP_HEAPIFY_RATIO) >= count) {
+		memcpy(&nodes[(count + 1ul) * width], from, width * length);
+
+		for (size_t i = next_count >> 1; i > 0ul; --i) {
+			memcpy(&next[0l], &nodes[i * width], width);
+			trickle_down(nodes, &next[0l], width,
+				     i, next_count, storage->compare);
+		}
+
+	} else {
+		for (size_t i = 0ul; i < length; ++i)
+			push_up(nodes, &from[i * width], width,
+				count + i + 1ul, storage->compare);
+	}
+
+	storage->count = next_count;
+}
+
+
+/* extraction
+ ******************************************************************************/
+void *mmheap_extract_min(struct MMHeap *heap)
+{
+	struct BHeap *const storage = heap->heap;
+
+	if (storage->count == 0ul)
+		return NULL;
+
+	char *const nodes  = storage->nodes;
+	const size_t width = storage->width;
+	char *const root   = &nodes[width];
+	char *const base   = &nodes[storage->count * width];
+	char next[width];
+
+	--(storage->count);
+
+	if (storage->count == 0ul)
+		return root;
+
+	/* park 'root' in the vacated 'base' slot and trickle old 'base' down
+	 * from the top */
+	memcpy(&next[0l], base, width);
+	memcpy(base,	  root, width);
+
+	trickle_down(nodes, &next[0l], width,
+		     1ul, storage->count, storage->compare);
+
+	return base;
+}
+
+void *mmheap_extract_max(struct MMHeap *heap)
+{
+	struct BHeap *const storage = heap->heap;
+
+	if (storage->count == 0ul)
+		return NULL;
+
+	const size_t i_max = mmheap_i_max(heap);
+	char *const nodes  = storage->nodes;
+	const size_t width = storage->width;
+	char *const base   = &nodes[storage->count * width];
+	char next[width];
+
+	/* the max is the last node already */
+	if (i_max == storage->count--)
+		return base;
+
+	memcpy(&next[0l], base,			 width);
+	memcpy(base,	  &nodes[i_max * width], width);
+
+	trickle_down(nodes, &next[0l], width,
+		     i_max, storage->count, storage->compare);
+
+	return base;
+}
@@ -0,0 +1,113 @@
+#ifndef MMHEAP_MMHEAP_H_
+#define MMHEAP_MMHEAP_H_
+#include <stdbool.h>		/* bool */
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE */
+#include <bheap/bheap.h>	/* struct BHeap */
+
+/*			- mmheap.h -
+ * double-ended (min-max) heap of fixed-width nodes
+ *
+ * A binary heap whose levels alternate between min levels (even depth, the
+ * root's) and max levels (odd depth): every node on a min level belongs above
+ * all of its descendants, and every node on a max level belongs below all of
+ * its descendants.  The first node is then the root and the last is one of
+ * its two children, so both ends can be read in O(1) and removed in
+ * O(log n), with one array of nodes instead of a pair of heaps kept in sync.
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y', as for
+ * 'struct BHeap'; "min" is the node extracted first and "max" the one
+ * extracted last.
+ *
+ * Storage is a binary 'struct BHeap' (1-based, 'nodes[2]' cache-aligned,
+ * same growth), whose nodes do not satisfy its own heap order -- only
+ * 'print_bheap' and the memory accounting apply to it.
+ */
+
+struct MMHeap {
+	struct BHeap *heap;
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+struct MMHeap *init_sized_mmheap(const size_t width,
+				 const size_t size,
+				 int (*compare)(const void *,
+						const void *));
+
+inline struct MMHeap *init_mmheap(const size_t width,
+				  int (*compare)(const void *,
+						 const void *))
+{
+	return init_sized_mmheap(width, BHEAP_DEFAULT_ALLOC, compare);
+}
+
+inline void clear_mmheap(struct MMHeap *heap)
+{
+	clear_bheap(heap->heap);
+}
+
+inline void free_mmheap(struct MMHeap *heap)
+{
+	free_bheap(heap->heap);
+	free(heap);
+}
+
+
+/* accessors
+ ******************************************************************************/
+inline size_t mmheap_count(const struct MMHeap *heap)
+{
+	return heap->heap->count;
+}
+
+/* index of the max node of a non-empty heap */
+inline size_t mmheap_i_max(const struct MMHeap *heap)
+{
+	const struct BHeap *const nodes = heap->heap;
+
+	if (nodes->count < 3ul)
+		return nodes->count;
+
+	return nodes->compare(&nodes->nodes[2ul * nodes->width],
+			      &nodes->nodes[3ul * nodes->width])
+	     ? 3ul
+	     : 2ul;
+}
+
+/* NULL if empty */
+inline const void *mmheap_peek_min(const struct MMHeap *heap)
+{
+	return (heap->heap->count == 0ul)
+	     ? NULL
+	     : &heap->heap->nodes[heap->heap->width];
+}
+
+/* NULL if empty */
+inline const void *mmheap_peek_max(const struct MMHeap *heap)
+{
+	return (heap->heap->count == 0ul)
+	     ? NULL
+	     : &heap->heap->nodes[mmheap_i_max(heap) * heap->heap->width];
+}
+
+
+/* insertion
+ ******************************************************************************/
+void mmheap_insert(struct MMHeap *heap,
+		   const void *const next);
+
+/* appends 'length' nodes and, when they are many relative to 'count'
+ * (see BHEAP_HEAPIFY_RATIO), rebuilds the order bottom up in linear time */
+void mmheap_insert_array(struct MMHeap *heap,
+			 const void *const array,
+			 const size_t length);
+
+
+/* extraction
+ ******************************************************************************/
+/* return a pointer to the extracted node, valid until the next call that
+ * modifies 'heap', or NULL if empty */
+void *mmheap_extract_min(struct MMHeap *heap);
+
+void *mmheap_extract_max(struct MMHeap *heap);
+#endif /* ifndef MMHEAP_MMHEAP_H_ */
@@ -0,0 +1,172 @@
+#define _POSIX_C_SOURCE 200809L	/* posix_memalign */
+#include <mqueue/mqueue.h>
+
+/* initialize, destroy
+ ******************************************************************************/
+struct MQueue *init_mqueue(const size_t width,
+			   const size_t count_shards,
+			   int (*compare)(const void *,
+					  const void *))
+{
+	struct MQueue *queue;
+	void *shards;
+
+	if (count_shards == 0ul)
+		EXIT_ON_FAILURE("count_shards must be positive");
+
+	HANDLE_MALLOC(queue, sizeof(struct MQueue));
+
+	if (posix_memalign(&shards, BHEAP_CACHE_LINE,
+			   sizeof(struct MQueueShard) * count_shards) != 0)
+		EXIT_ON_FAILURE("failed to allocate %lu shards", count_shards);
+
+	queue->count_shards = count_shards;
+	queue->width	    = width;
+	queue->shards	    = (struct MQueueShard *) shards;
+	queue->compare	    = compare;
+
+	for (size_t i = 0ul; i < count_shards; ++i) {
+		if (pthread_mutex_init(&queue->shards[i].lock, NULL) != 0)
+			EXIT_ON_FAILURE("failed to initialize lock %lu", i);
+
+		queue->shards[i].heap = init_bheap(width, compare);
+	}
+
+	return queue;
+}
+
+void free_mqueue(struct MQueue *queue)
+{
+	for (size_t i = 0ul; i < queue->count_shards; ++i) {
+		pthread_mutex_destroy(&queue->shards[i].lock);
+		free_bheap(queue->shards[i].heap);
+	}
+
+	free(queue->shards);
+	free(queue);
+}
+
+
+static inline struct MQueueShard *random_shard(struct MQueue *queue,
+					       pcg32_random_t *rng)
+{
+	return &queue->shards[pcg32_boundedrand_r(rng,
+						  queue->count_shards)];
+}
+
+static inline const void *shard_root(const struct MQueueShard *shard)
+{
+	return &shard->heap->nodes[shard->heap->width];
+}
+
+/* extracts root of locked, non-empty 'shard' into 'out' and unlocks it */
+static inline void take_root(struct MQueueShard *shard,
+			     void *const out,
+			     const size_t width)
+{
+	memcpy(out, bheap_extract(shard->heap), width);
+	pthread_mutex_unlock(&shard->lock);
+}
+
+
+/* insertion
+ ******************************************************************************/
+void mqueue_insert(struct MQueue *queue,
+		   pcg32_random_t *rng,
+		   const void *const next)
+{
+	struct MQueueShard *shard;
+
+	for (unsigned int tries = 0u; tries < MQUEUE_MAX_TRIES; ++tries) {
+		shard = random_shard(queue, rng);
+
+		if (pthread_mutex_trylock(&shard->lock) == 0) {
+			bheap_insert(shard->heap, next);
+			pthread_mutex_unlock(&shard->lock);
+			return;
+		}
+	}
+
+	/* heavily contended, wait on a shard */
+	shard = random_shard(queue, rng);
+	pthread_mutex_lock(&shard->lock);
+	bheap_insert(shard->heap, next);
+	pthread_mutex_unlock(&shard->lock);
+}
+
+
+/* extraction
+ ******************************************************************************/
+bool mqueue_extract(struct MQueue *queue,
+		    pcg32_random_t *rng,
+		    void *const out)
+{
+	const size_t width = queue->width;
+	struct MQueueShard *first, *second, *best;
+
+	for (unsigned int tries = 0u; tries < MQUEUE_MAX_TRIES; ++tries) {
+		first  = random_shard(queue, rng);
+		second = random_shard(queue, rng);
+
+		if (pthread_mutex_trylock(&first->lock) != 0)
+			continue;
+
+		best = first;
+
+		/* two choices: keep whichever root belongs above the other */
+		if ((second != first)
+		    && (pthread_mutex_trylock(&second->lock) == 0)) {
+			if ((second->heap->count > 0ul)
+			    && ((first->heap->count == 0ul)
+				|| queue->compare(shard_root(second),
+						  shard_root(first))))
+				best = second;
+
+			pthread_mutex_unlock((best == first)
+					     ? &second->lock
+					     : &first->lock);
+		}
+
+		if (best->heap->count > 0ul) {
+			take_root(best, out, width);
+			return true;
+		}
+
+		pthread_mutex_unlock(&best->lock);
+	}
+
+	/* sampled shards were empty or contended, sweep every shard once
+	 * before reporting empty */
+	const size_t i_start = pcg32_boundedrand_r(rng, queue->count_shards);
+
+	for (size_t k = 0ul; k < queue->count_shards; ++k) {
+		best = &queue->shards[(i_start + k) % queue->count_shards];
+
+		pthread_mutex_lock(&best->lock);
+
+		if (best->heap->count > 0ul) {
+			take_root(best, out, width);
+			return true;
+		}
+
+		pthread_mutex_unlock(&best->lock);
+	}
+
+	return false;
+}
+
+
+/* inspection
+ ******************************************************************************/
+size_t mqueue_count(struct MQueue *queue)
+{
+	size_t count = 0ul;
+
+	for (size_t i = 0ul; i < queue->count_shards; ++i) {
+		pthread_mutex_lock(&queue->shards[i].lock);
+		count += queue->shards[i].heap->count;
+		pthread_mutex_unlock(&queue->shards[i].lock);
+	}
+
+	return count;
+}
@@ -0,0 +1,70 @@
+#ifndef MQUEUE_MQUEUE_H_
+#define MQUEUE_MQUEUE_H_
+#include <stdbool.h>		/* bool */
+#include <pthread.h>		/* pthread_mutex_t */
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE */
+#include <utils/pcg_basic.h>	/* pcg32_random_t */
+#include <bheap/bheap.h>	/* struct BHeap, BHEAP_CACHE_LINE */
+
+/*			- mqueue.h -
+ * relaxed concurrent priority queue (MultiQueue) over 'c * P' independently
+ * locked 'struct BHeap' shards
+ *
+ * Insertion goes to a random shard, extraction takes the better root of two
+ * random shards.  Extraction order is only approximately that of a single
+ * heap (the expected rank error is O(shards)), in exchange for throughput
+ * that scales with threads instead of serializing on one lock.
+ *
+ * Every calling thread passes its own pcg32 state ('rng'), seeded with a
+ * distinct sequence (e.g. 'pcg32_srandom_r(&rng, seed, thread_id)').
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ */
+
+/* failed 'pthread_mutex_trylock' attempts before an operation blocks */
+#define MQUEUE_MAX_TRIES 8u
+
+struct MQueueShard {
+	pthread_mutex_t lock;
+	struct BHeap *heap;
+} __attribute__((aligned(BHEAP_CACHE_LINE)));
+
+struct MQueue {
+	size_t count_shards;
+	size_t width;		/* byte size per node */
+	struct MQueueShard *shards;
+	int (*compare)(const void *,
+		       const void *);
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+/* 'count_shards' is typically 'c * P' for 'P' threads, 'c' in [2, 4] */
+struct MQueue *init_mqueue(const size_t width,
+			   const size_t count_shards,
+			   int (*compare)(const void *,
+					  const void *));
+
+void free_mqueue(struct MQueue *queue);
+
+
+/* insertion
+ ******************************************************************************/
+void mqueue_insert(struct MQueue *queue,
+		   pcg32_random_t *rng,
+		   const void *const next);
+
+
+/* extraction
+ ******************************************************************************/
+/* copies an (approximately) best node into 'out' and returns true, or returns
+ * false if every shard was found empty */
+bool mqueue_extract(struct MQueue *queue,
+		    pcg32_random_t *rng,
+		    void *const out);
+
+
+/* inspection (not linearizable while other threads are active)
+ ******************************************************************************/
+size_t mqueue_count(struct MQueue *queue);
+#endif /* ifndef MQUEUE_MQUEUE_H_ */
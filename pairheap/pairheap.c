@@ -0,0 +1,263 @@
+#include <pairheap/pairheap.h>
+
+/* initialize, destroy
+ ******************************************************************************/
+extern inline struct PairPool *init_sized_pairpool(const size_t width,
+						   const size_t size,
+						   int (*compare)(const void *,
+								  const void *));
+
+extern inline struct PairPool *init_pairpool(const size_t width,
+					     int (*compare)(const void *,
+							    const void *));
+
+extern inline void free_pairpool(struct PairPool *pool);
+
+extern inline struct PairHeap *init_pairheap(struct PairPool *pool);
+
+extern inline void free_pairheap(struct PairHeap *heap);
+
+
+/* accessors
+ ******************************************************************************/
+extern inline size_t pairheap_count(const struct PairHeap *heap);
+
+extern inline void *pairheap_node(const struct PairHeap *heap,
+				  const size_t handle);
+
+extern inline size_t pairheap_peek(const struct PairHeap *heap);
+
+
+/* pool
+ ******************************************************************************/
+static inline void *pool_node(const struct PairPool *pool,
+			      const size_t handle)
+{
+	return &pool->slab[handle * pool->width];
+}
+
+static size_t pool_alloc(struct PairPool *pool)
+{
+	size_t handle = pool->free_head;
+
+	if (handle != PAIRHEAP_NULL_HANDLE) {
+		pool->free_head = pool->links[handle].next;
+		return handle;
+	}
+
+	if (pool->used == pool->alloc) {
+		pool->alloc *= 2ul;
+
+		HANDLE_REALLOC(pool->links,
+			       sizeof(struct PairLink) * pool->alloc);
+		HANDLE_REALLOC(pool->slab, pool->width * pool->alloc);
+	}
+
+	return (pool->used)++;
+}
+
+static inline void pool_release(struct PairPool *pool,
+				const size_t handle)
+{
+	pool->links[handle].next = pool->free_head;
+	pool->free_head		 = handle;
+}
+
+/* links roots 'x' and 'y', the loser becoming the first child of the winner,
+ * and returns the winner ('next' and 'prev' of the winner are left as were) */
+static inline size_t link(const struct PairPool *pool,
+			  size_t x,
+			  size_t y)
+{
+	struct PairLink *const links = pool->links;
+	size_t swap;
+
+	if (pool->compare(pool_node(pool, y), pool_node(pool, x))) {
+		swap = x;
+		x    = y;
+		y    = swap;
+	}
+
+	links[y].next = links[x].child;
+	links[y].prev = x;
+
+	if (links[x].child != PAIRHEAP_NULL_HANDLE)
+		links[links[x].child].prev = y;
+
+	links[x].child = y;
+
+	return x;
+}
+
+static inline size_t link_root(const struct PairPool *pool,
+			       const size_t root,
+			       const size_t next)
+{
+	const size_t winner = link(pool, root, next);
+
+	pool->links[winner].next = PAIRHEAP_NULL_HANDLE;
+	pool->links[winner].prev = PAIRHEAP_NULL_HANDLE;
+
+	return winner;
+}
+
+void clear_pairheap(struct PairHeap *heap)
+{
+	struct PairPool *const pool  = heap->pool;
+	struct PairLink *const links = pool->links;
+	size_t work = heap->root;
+	size_t node, tail;
+
+	/* release 'work' and its siblings, splicing in each child list ahead of
+	 * its parent, so every sibling list is walked once */
+	while (work != PAIRHEAP_NULL_HANDLE) {
+		node = work;
+
+		if (links[node].child != PAIRHEAP_NULL_HANDLE) {
+			work = links[node].child;
+			links[node].child = PAIRHEAP_NULL_HANDLE;
+
+			for (tail = work;
+			     links[tail].next != PAIRHEAP_NULL_HANDLE;
+			     tail = links[tail].next);
+
+			links[tail].next = node;
+			continue;
+		}
+
+		work = links[node].next;
+		pool_release(pool, node);
+	}
+
+	heap->count = 0ul;
+	heap->root  = PAIRHEAP_NULL_HANDLE;
+}
+
+
+/* insertion, meld
+ ******************************************************************************/
+size_t pairheap_insert(struct PairHeap *heap,
+		       const void *const next)
+{
+	struct PairPool *const pool = heap->pool;
+	const size_t handle	    = pool_alloc(pool);
+	struct PairLink *const link_next = &pool->links[handle];
+
+	link_next->child = PAIRHEAP_NULL_HANDLE;
+	link_next->next	 = PAIRHEAP_NULL_HANDLE;
+	link_next->prev	 = PAIRHEAP_NULL_HANDLE;
+
+	memcpy(pool_node(pool, handle), next, pool->width);
+
+	heap->root = (heap->root == PAIRHEAP_NULL_HANDLE)
+		   ? handle
+		   : link_root(pool, heap->root, handle);
+
+	++(heap->count);
+
+	return handle;
+}
+
+void pairheap_meld(struct PairHeap *heap,
+		   struct PairHeap *other)
+{
+	if (heap->pool != other->pool)
+		EXIT_ON_FAILURE("cannot meld heaps drawing from different "
+				"pools");
+
+	if (other->root == PAIRHEAP_NULL_HANDLE)
+		return;
+
+	heap->root = (heap->root == PAIRHEAP_NULL_HANDLE)
+		   ? other->root
+		   : link_root(heap->pool, heap->root, other->root);
+
+	heap->count += other->count;
+
+	other->count = 0ul;
+	other->root  = PAIRHEAP_NULL_HANDLE;
+}
+
+
+/* extraction
+ ******************************************************************************/
+void *pairheap_extract(struct PairHeap *heap)
+{
+	struct PairPool *const pool  = heap->pool;
+	struct PairLink *const links = pool->links;
+	const size_t root	     = heap->root;
+	size_t first, second, rest, pairs, merged;
+
+	if (root == PAIRHEAP_NULL_HANDLE)
+		return NULL;
+
+	/* pass 1: link children in pairs left to right, stacking the winners
+	 * through 'next' (rightmost on top) */
+	pairs = PAIRHEAP_NULL_HANDLE;
+
+	for (first = links[root].child; first != PAIRHEAP_NULL_HANDLE;
+	     first = rest) {
+		second = links[first].next;
+
+		if (second == PAIRHEAP_NULL_HANDLE) {
+			rest   = PAIRHEAP_NULL_HANDLE;
+			merged = first;
+		} else {
+			rest   = links[second].next;
+			merged = link(pool, first, second);
+		}
+
+		links[merged].next = pairs;
+		pairs		   = merged;
+	}
+
+	/* pass 2: link the pairs right to left into one tree */
+	if (pairs != PAIRHEAP_NULL_HANDLE) {
+		merged = pairs;
+		pairs  = links[pairs].next;
+
+		while (pairs != PAIRHEAP_NULL_HANDLE) {
+			rest   = links[pairs].next;
+			merged = link(pool, merged, pairs);
+			pairs  = rest;
+		}
+
+		links[merged].next = PAIRHEAP_NULL_HANDLE;
+		links[merged].prev = PAIRHEAP_NULL_HANDLE;
+	} else {
+		merged = PAIRHEAP_NULL_HANDLE;
+	}
+
+	heap->root = merged;
+	--(heap->count);
+
+	pool_release(pool, root);
+
+	return pool_node(pool, root);
+}
+
+
+/* priority changes
+ ******************************************************************************/
+void pairheap_decrease_key(struct PairHeap *heap,
+			   const size_t handle)
+{
+	struct PairPool *const pool  = heap->pool;
+	struct PairLink *const links = pool->links;
+	const size_t prev	     = links[handle].prev;
+	const size_t next	     = links[handle].next;
+
+	if (handle == heap->root)
+		return;
+
+	/* cut the subtree at 'handle' out of its sibling list */
+	if (links[prev].child == handle)
+		links[prev].child = next;
+	else
+		links[prev].next = next;
+
+	if (next != PAIRHEAP_NULL_HANDLE)
+		links[next].prev = prev;
+
+	heap->root = link_root(pool, heap->root, handle);
+}
@@ -0,0 +1,159 @@
+#ifndef PAIRHEAP_PAIRHEAP_H_
+#define PAIRHEAP_PAIRHEAP_H_
+#include <utils/utils.h>	/* HANDLE_MALLOC, HANDLE_REALLOC */
+
+/*			- pairheap.h -
+ * mergeable pairing heap over a shared node pool
+ *
+ * Nodes of 'width' bytes live in a 'struct PairPool': a slab named by stable
+ * handles, with a parallel array of tree links (first child, next sibling,
+ * previous sibling or parent) and a free list threaded through released
+ * nodes.  Any number of 'struct PairHeap's draw from one pool, so melding two
+ * of them links their roots -- O(1), no node is copied.  Insertion links a
+ * single node the same way.  Extraction pairs up the root's children left to
+ * right, then links the pairs right to left (two-pass): O(log n) amortized.
+ * Decrease-key cuts the node's subtree and links it with the root.
+ *
+ * Handles stay valid across pool growth (the slab may move, so re-fetch node
+ * pointers after an insertion).
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ */
+
+#define PAIRHEAP_NULL_HANDLE   ((size_t) -1)
+#define PAIRHEAP_DEFAULT_ALLOC 64ul
+
+struct PairLink {
+	size_t child;		/* first child */
+	size_t next;		/* next sibling, next free node once released */
+	size_t prev;		/* previous sibling, parent if first child */
+};
+
+struct PairPool {
+	size_t width;		/* byte size per node */
+	size_t alloc;		/* count of allocated nodes */
+	size_t used;		/* count of nodes ever handed out */
+	size_t free_head;	/* list of released nodes through 'next' */
+	struct PairLink *links;	/* links[handle] */
+	char *slab;		/* slab[handle * width] = node */
+	int (*compare)(const void *,
+		       const void *);
+};
+
+struct PairHeap {
+	size_t count;		/* count of nodes */
+	size_t root;		/* PAIRHEAP_NULL_HANDLE if empty */
+	struct PairPool *pool;
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+inline struct PairPool *init_sized_pairpool(const size_t width,
+					    const size_t size,
+					    int (*compare)(const void *,
+							   const void *))
+{
+	/* room to grow by doubling, even if sized for nothing */
+	const size_t alloc = (size < PAIRHEAP_DEFAULT_ALLOC)
+			   ? PAIRHEAP_DEFAULT_ALLOC
+			   : size;
+	struct PairPool *pool;
+
+	HANDLE_MALLOC(pool, sizeof(struct PairPool));
+	HANDLE_MALLOC(pool->links, sizeof(struct PairLink) * alloc);
+	HANDLE_MALLOC(pool->slab,  width * alloc);
+
+	pool->width	= width;
+	pool->alloc	= alloc;
+	pool->used	= 0ul;
+	pool->free_head = PAIRHEAP_NULL_HANDLE;
+	pool->compare	= compare;
+
+	return pool;
+}
+
+inline struct PairPool *init_pairpool(const size_t width,
+				      int (*compare)(const void *,
+						     const void *))
+{
+	return init_sized_pairpool(width, PAIRHEAP_DEFAULT_ALLOC, compare);
+}
+
+/* frees the nodes of every heap drawing from 'pool' (free the heaps too) */
+inline void free_pairpool(struct PairPool *pool)
+{
+	free(pool->links);
+	free(pool->slab);
+	free(pool);
+}
+
+inline struct PairHeap *init_pairheap(struct PairPool *pool)
+{
+	struct PairHeap *heap;
+
+	HANDLE_MALLOC(heap, sizeof(struct PairHeap));
+
+	heap->count = 0ul;
+	heap->root  = PAIRHEAP_NULL_HANDLE;
+	heap->pool  = pool;
+
+	return heap;
+}
+
+/* releases every node of 'heap' to its pool, O(n) */
+void clear_pairheap(struct PairHeap *heap);
+
+inline void free_pairheap(struct PairHeap *heap)
+{
+	clear_pairheap(heap);
+	free(heap);
+}
+
+
+/* accessors
+ ******************************************************************************/
+inline size_t pairheap_count(const struct PairHeap *heap)
+{
+	return heap->count;
+}
+
+/* node named by 'handle', until the next insertion into the pool */
+inline void *pairheap_node(const struct PairHeap *heap,
+			   const size_t handle)
+{
+	return &heap->pool->slab[handle * heap->pool->width];
+}
+
+/* handle of the root, PAIRHEAP_NULL_HANDLE if empty */
+inline size_t pairheap_peek(const struct PairHeap *heap)
+{
+	return heap->root;
+}
+
+
+/* insertion, meld
+ ******************************************************************************/
+/* copies 'next' into the pool and returns its handle */
+size_t pairheap_insert(struct PairHeap *heap,
+		       const void *const next);
+
+/* moves every node of 'other' into 'heap', leaving 'other' empty (both must
+ * draw from the same pool) */
+void pairheap_meld(struct PairHeap *heap,
+		   struct PairHeap *other);
+
+
+/* extraction
+ ******************************************************************************/
+/* returns a pointer to the extracted node, valid until the next insertion
+ * into the pool, or NULL if empty */
+void *pairheap_extract(struct PairHeap *heap);
+
+
+/* priority changes
+ ******************************************************************************/
+/* restores heap order after the node at 'handle' has been modified in place
+ * (through 'pairheap_node') to belong at least as high as before */
+void pairheap_decrease_key(struct PairHeap *heap,
+			   const size_t handle);
+#endif /* ifndef PAIRHEAP_PAIRHEAP_H_ */
@@ -0,0 +1,220 @@
+#define _POSIX_C_SOURCE 200809L	/* posix_memalign */
+#define _DEFAULT_SOURCE		/* madvise */
+#include <stdlib.h>		/* posix_memalign */
+#include <sys/mman.h>		/* madvise */
+#include <pheap/pheap.h>
+
+/* allocation
+ ******************************************************************************/
+static char *alloc_pages(const size_t page_bytes,
+			 const size_t bytes)
+{
+	void *block;
+
+	if (posix_memalign(&block, page_bytes, bytes) != 0)
+		EXIT_ON_FAILURE("failed to allocate %lu bytes aligned to %lu",
+				bytes, page_bytes);
+
+#ifdef MADV_HUGEPAGE
+	/* best effort: without transparent huge pages this is a no-op */
+	if (page_bytes >= PHEAP_HUGE_PAGE_BYTES)
+		(void) madvise(block, bytes, MADV_HUGEPAGE);
+#endif /* ifdef MADV_HUGEPAGE */
+
+	return (char *) block;
+}
+
+static inline size_t page_stride(const struct PHeap *heap)
+{
+	return heap->width << heap->log_page;
+}
+
+static void grow_pheap(struct PHeap *heap)
+{
+	const size_t alloc = heap->alloc * 2ul;
+	char *const nodes  = alloc_pages(heap->page_bytes,
+					 alloc * page_stride(heap));
+
+	memcpy(nodes, heap->nodes, heap->alloc * page_stride(heap));
+	free(heap->nodes);
+
+	heap->nodes = nodes;
+	heap->alloc = alloc;
+}
+
+
+/* shift up, shift down
+ ******************************************************************************/
+static inline void shift_up(char *const nodes,
+			    const void *const next,
+			    const size_t width,
+			    size_t i_next,
+			    const unsigned int log_page,
+			    int (*compare)(const void *,
+					   const void *))
+{
+	size_t i_parent;
+
+	while (i_next > 1ul) {
+		i_parent = pheap_i_parent(i_next, log_page);
+
+		if (!compare(next, &nodes[i_parent * width]))
+			break;
+
+		memcpy(&nodes[i_next * width], &nodes[i_parent * width], width);
+		i_next = i_parent;
+	}
+
+	memcpy(&nodes[i_next * width], next, width);
+}
+
+/* slots fill in order, so a child exists iff it is at or before 'i_base' */
+static inline void shift_down(char *const nodes,
+			      const void *const next,
+			      const size_t width,
+			      size_t i_next,
+			      const size_t i_base,
+			      const unsigned int log_page,
+			      int (*compare)(const void *,
+					     const void *))
+{
+	size_t i_child;
+
+	while ((i_child = pheap_i_child(i_next, log_page)) <= i_base) {
+		if ((i_child < i_base)
+		    && compare(&nodes[(i_child + 1ul) * width],
+			       &nodes[i_child * width]))
+			++i_child;
+
+		if (!compare(&nodes[i_child * width], next))
+			break;
+
+		memcpy(&nodes[i_next * width], &nodes[i_child * width], width);
+		i_next = i_child;
+	}
+
+	memcpy(&nodes[i_next * width], next, width);
+}
+
+
+/* initialize, destroy
+ ******************************************************************************/
+struct PHeap *init_paged_pheap(const size_t width,
+			       const size_t page_bytes,
+			       int (*compare)(const void *,
+					      const void *))
+{
+	struct PHeap *heap;
+	unsigned int log_page = 0u;
+
+	if ((page_bytes & (page_bytes - 1ul)) != 0ul)
+		EXIT_ON_FAILURE("page size (%lu) must be a power of two",
+				page_bytes);
+
+	while ((width << (log_page + 1u)) <= page_bytes)
+		++log_page;
+
+	if (log_page < 2u)
+		EXIT_ON_FAILURE("page size (%lu) must hold four nodes of width "
+				"%lu", page_bytes, width);
+
+	HANDLE_MALLOC(heap, sizeof(struct PHeap));
+
+	heap->count	 = 0ul;
+	heap->i_base	 = 0ul;
+	heap->alloc	 = 1ul;
+	heap->width	 = width;
+	heap->page_bytes = page_bytes;
+	heap->log_page	 = log_page;
+	heap->compare	 = compare;
+	heap->nodes	 = alloc_pages(page_bytes, page_stride(heap));
+
+	return heap;
+}
+
+extern inline struct PHeap *init_pheap(const size_t width,
+				       int (*compare)(const void *,
+						      const void *));
+
+extern inline void clear_pheap(struct PHeap *heap);
+
+extern inline void free_pheap(struct PHeap *heap);
+
+
+/* index math
+ ******************************************************************************/
+extern inline size_t pheap_i_child(const size_t i_slot,
+				   const unsigned int log_page);
+
+extern inline size_t pheap_i_parent(const size_t i_slot,
+				    const unsigned int log_page);
+
+
+/* accessors
+ ******************************************************************************/
+extern inline size_t pheap_count(const struct PHeap *heap);
+
+extern inline const void *pheap_peek(const struct PHeap *heap);
+
+
+/* insertion
+ ******************************************************************************/
+void pheap_insert(struct PHeap *heap,
+		  const void *const next)
+{
+	const size_t mask = (1ul << heap->log_page) - 1ul;
+	size_t i_next	  = heap->i_base + 1ul;
+
+	/* skip the unused first slots of a new page */
+	if ((i_next & mask) == 0ul) {
+		i_next += 2ul;
+
+		if ((i_next >> heap->log_page) >= heap->alloc)
+			grow_pheap(heap);
+	}
+
+	++(heap->count);
+	heap->i_base = i_next;
+
+	shift_up(heap->nodes, next, heap->width, i_next, heap->log_page,
+		 heap->compare);
+}
+
+
+/* extraction
+ ******************************************************************************/
+void *pheap_extract(struct PHeap *heap)
+{
+	if (heap->count == 0ul)
+		return NULL;
+
+	char *const nodes  = heap->nodes;
+	const size_t width = heap->width;
+	const size_t mask  = (1ul << heap->log_page) - 1ul;
+	char *const root   = &nodes[width];
+	char *const base   = &nodes[heap->i_base * width];
+	char next[width];
+
+	--(heap->count);
+
+	if (heap->count == 0ul) {
+		heap->i_base = 0ul;
+		return root;
+	}
+
+	/* past the unused first slots of an emptied page (the first page
+	 * starts at slot 1) */
+	heap->i_base -= (((heap->i_base & mask) == 2ul) && (heap->i_base > mask))
+		      ? 3ul
+		      : 1ul;
+
+	/* park 'root' in the vacated 'base' slot and shift old 'base' down from
+	 * the top */
+	memcpy(&next[0l], base, width);
+	memcpy(base,	  root, width);
+
+	shift_down(nodes, &next[0l], width,
+		   1ul, heap->i_base, heap->log_page, heap->compare);
+
+	return base;
+}
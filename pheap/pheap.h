@@ -0,0 +1,133 @@
+#ifndef PHEAP_PHEAP_H_
+#define PHEAP_PHEAP_H_
+#include <stdbool.h>		/* bool */
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE */
+
+/*			- pheap.h -
+ * page-aware binary heap (B-heap) of fixed-width nodes
+ *
+ * In a flat heap every level of a deep shift lands on a different page once
+ * the heap outgrows the TLB.  Here nodes are stored in pages of 'page_nodes'
+ * (a power of two) slots, each holding a pair of sibling subtrees in local
+ * heap order, after Kamp's B-heap: their roots sit in slots 2 and 3 (slots 0
+ * and 1 are unused), a node in slot 'j' below 'page_nodes / 2' has its
+ * children in slots '2j' and '2j + 1' of the same page, and the children of
+ * each node in the page's bottom row are the root pair of a page of their
+ * own.  The first page holds the heap root in slot 1 instead.  A shift then
+ * touches one page per 'log2(page_nodes) - 1' levels instead of nearly one
+ * per level, and siblings always share a page.
+ *
+ * Pages are filled in order, so the heap is still extended and shrunk at one
+ * end, and the index math stays behind 'pheap_insert'/'pheap_extract'.  The
+ * node array is aligned to 'page_bytes', which should be a multiple of 'width'
+ * for pages of nodes to match pages of memory.
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ */
+
+#define PHEAP_PAGE_BYTES      4096ul
+#define PHEAP_HUGE_PAGE_BYTES (2ul << 20)
+
+struct PHeap {
+	size_t count;		/* count of occupied nodes */
+	size_t i_base;		/* slot of the last node, 0 if empty */
+	size_t alloc;		/* count of allocated pages */
+	size_t width;		/* byte size per node */
+	size_t page_bytes;	/* alignment of 'nodes' */
+	unsigned int log_page;	/* log2 of slots per page */
+	char *nodes;		/* slot 'i' at 'nodes[i * width]' */
+	int (*compare)(const void *,
+		       const void *);
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+/* 'page_bytes' is a power of two holding at least four nodes (for
+ * PHEAP_HUGE_PAGE_BYTES the node array is advised to use huge pages) */
+struct PHeap *init_paged_pheap(const size_t width,
+			       const size_t page_bytes,
+			       int (*compare)(const void *,
+					      const void *));
+
+inline struct PHeap *init_pheap(const size_t width,
+				int (*compare)(const void *,
+					       const void *))
+{
+	return init_paged_pheap(width, PHEAP_PAGE_BYTES, compare);
+}
+
+inline void clear_pheap(struct PHeap *heap)
+{
+	heap->count  = 0ul;
+	heap->i_base = 0ul;
+}
+
+inline void free_pheap(struct PHeap *heap)
+{
+	free(heap->nodes);
+	free(heap);
+}
+
+
+/* index math
+ ******************************************************************************/
+/* first of the two children of slot 'i_slot' (the second is the next slot) */
+inline size_t pheap_i_child(const size_t i_slot,
+			    const unsigned int log_page)
+{
+	const size_t half = 1ul << (log_page - 1u);
+	const size_t j	  = i_slot & ((1ul << log_page) - 1ul);
+
+	if (j < half)
+		return i_slot + j;
+
+	/* bottom row: root pair of child page 'page * half + (j - half) + 1' */
+	return ((((i_slot >> log_page) << (log_page - 1u)) + (j - half) + 1ul)
+		<< log_page) + 2ul;
+}
+
+/* slot 1 (the root) has no parent */
+inline size_t pheap_i_parent(const size_t i_slot,
+			     const unsigned int log_page)
+{
+	const size_t half = 1ul << (log_page - 1u);
+	const size_t j	  = i_slot & ((1ul << log_page) - 1ul);
+	const size_t page = i_slot >> log_page;
+
+	if ((j >= 4ul) || (page == 0ul))
+		return i_slot - j + (j >> 1);
+
+	/* root pair: under a bottom-row node of the parent page */
+	return (((page - 1ul) >> (log_page - 1u)) << log_page)
+	     + half + ((page - 1ul) & (half - 1ul));
+}
+
+
+/* accessors
+ ******************************************************************************/
+inline size_t pheap_count(const struct PHeap *heap)
+{
+	return heap->count;
+}
+
+/* NULL if empty */
+inline const void *pheap_peek(const struct PHeap *heap)
+{
+	return (heap->count == 0ul)
+	     ? NULL
+	     : &heap->nodes[heap->width];
+}
+
+
+/* insertion
+ ******************************************************************************/
+void pheap_insert(struct PHeap *heap,
+		  const void *const next);
+
+
+/* extraction
+ ******************************************************************************/
+/* returns a pointer to the extracted node, valid until the next call that
+ * modifies 'heap', or NULL if empty */
+void *pheap_extract(struct PHeap *heap);
+#endif /* ifndef PHEAP_PHEAP_H_ */
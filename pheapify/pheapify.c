@@ -0,0 +1,198 @@
+#define _POSIX_C_SOURCE 200809L	/* sysconf */
+#include <pthread.h>		/* pthread_create, pthread_join */
+#include <unistd.h>		/* sysconf */
+#include <pheapify/pheapify.h>
+
+struct PHeapify {
+	char *nodes;		/* 1-based, 'length' nodes */
+	const char *array;
+	size_t length;
+	size_t width;
+	unsigned int log_arity;
+	size_t count;		/* count of threads */
+	ptrdiff_t i_first_root;	/* subtree roots handed out to threads */
+	ptrdiff_t i_last_root;
+	size_t next_root;	/* offset of the next root to hand out */
+	int (*compare)(const void *,
+		       const void *);
+};
+
+struct PHeapifyJob {
+	pthread_t thread;
+	struct PHeapify *build;
+	size_t index;
+};
+
+static inline size_t chunk_start(const struct PHeapify *build,
+				 const size_t chunk)
+{
+	return (build->length * chunk) / build->count;
+}
+
+/* Floyd over the subtree at 'i_root' only: the descendants of 'i_root' at each
+ * depth are a contiguous range, shifted down in descending order from the
+ * deepest range holding parents up */
+static void heapify_subtree(const struct PHeapify *build,
+			    const ptrdiff_t i_root)
+{
+	const size_t width	     = build->width;
+	const unsigned int log_arity = build->log_arity;
+	const ptrdiff_t i_base	     = (ptrdiff_t) build->length;
+	const ptrdiff_t i_last	     = bheap_i_parent(i_base, log_arity);
+	ptrdiff_t i_lo[64];
+	ptrdiff_t i_hi[64];
+	size_t depth = 0ul;
+	char next[width];
+
+	for (ptrdiff_t lo = i_root, hi = i_root; lo <= i_last; ++depth) {
+		i_lo[depth] = lo;
+		i_hi[depth] = (hi < i_last) ? hi : i_last;
+
+		lo = bheap_i_child(lo, log_arity);
+		hi = bheap_i_child(hi, log_arity) + (1l << log_arity) - 1l;
+	}
+
+	while (depth-- > 0ul)
+		for (ptrdiff_t i = i_hi[depth]; i >= i_lo[depth]; --i) {
+			memcpy(&next[0l], &build->nodes[i * width], width);
+			do_dary_bheap_shift(build->nodes, &next[0l], width, i,
+					    i_base, log_arity, build->compare);
+		}
+}
+
+
+/* thread routines
+ ******************************************************************************/
+static void *copy_chunk(void *arg)
+{
+	const struct PHeapifyJob *const job = (const struct PHeapifyJob *) arg;
+	const struct PHeapify *const build  = job->build;
+	const size_t start = chunk_start(build, job->index) * build->width;
+	const size_t end   = chunk_start(build, job->index + 1ul) * build->width;
+
+	memcpy(&build->nodes[build->width + start], &build->array[start],
+	       end - start);
+
+	return NULL;
+}
+
+static void *heapify_subtrees(void *arg)
+{
+	const struct PHeapifyJob *const job = (const struct PHeapifyJob *) arg;
+	struct PHeapify *const build	    = job->build;
+	ptrdiff_t i_root;
+
+	while (1) {
+		i_root = build->i_first_root
+		       + (ptrdiff_t) __atomic_fetch_add(&build->next_root, 1ul,
+							__ATOMIC_RELAXED);
+
+		if (i_root > build->i_last_root)
+			return NULL;
+
+		heapify_subtree(build, i_root);
+	}
+}
+
+/* runs 'routine' for every job, job 0 on the calling thread */
+static void run_jobs(struct PHeapifyJob *jobs,
+		     const size_t count,
+		     void *(*routine)(void *))
+{
+	for (size_t i = 1ul; i < count; ++i)
+		if (pthread_create(&jobs[i].thread, NULL, routine,
+				   &jobs[i]) != 0)
+			EXIT_ON_FAILURE("failed to create thread %lu", i);
+
+	(void) routine(&jobs[0l]);
+
+	for (size_t i = 1ul; i < count; ++i)
+		pthread_join(jobs[i].thread, NULL);
+}
+
+
+/* build
+ ******************************************************************************/
+struct BHeap *parray_into_dary_bheap(const void *const array,
+				     const size_t length,
+				     const size_t width,
+				     const size_t arity,
+				     const size_t count_threads,
+				     int (*compare)(const void *,
+						    const void *))
+{
+	struct PHeapify build;
+	struct PHeapifyJob *jobs;
+	struct BHeap *heap;
+	ptrdiff_t i_level, level_length;
+	size_t count = (count_threads == 0ul)
+		     ? (size_t) sysconf(_SC_NPROCESSORS_ONLN)
+		     : count_threads;
+
+	if ((count < 2ul) || (length < PHEAPIFY_MIN_LENGTH))
+		return array_into_dary_bheap(array, length, width, arity,
+					     compare);
+
+	heap = init_sized_dary_bheap(width, length, arity, compare);
+
+	build.nodes	= heap->nodes;
+	build.array	= (const char *) array;
+	build.length	= length;
+	build.width	= width;
+	build.log_arity = heap->log_arity;
+	build.count	= count;
+	build.next_root = 0ul;
+	build.compare	= compare;
+
+	/* first level with enough subtrees to go around */
+	i_level	     = 1l;
+	level_length = 1l;
+	while ((size_t) level_length < (count * PHEAPIFY_ROOTS_PER_THREAD)) {
+		i_level	       = bheap_i_child(i_level, build.log_arity);
+		level_length <<= build.log_arity;
+	}
+
+	/* roots past the last parent are leaves, already heaps */
+	build.i_first_root = i_level;
+	build.i_last_root  = i_level + level_length - 1l;
+
+	if (build.i_last_root > bheap_i_parent(length, build.log_arity))
+		build.i_last_root = bheap_i_parent(length, build.log_arity);
+
+	HANDLE_MALLOC(jobs, sizeof(struct PHeapifyJob) * count);
+
+	for (size_t i = 0ul; i < count; ++i) {
+		jobs[i].build = &build;
+		jobs[i].index = i;
+	}
+
+	run_jobs(jobs, count, &copy_chunk);
+	run_jobs(jobs, count, &heapify_subtrees);
+
+	free(jobs);
+
+	/* levels above the subtrees */
+	char next[width];
+
+	for (ptrdiff_t i = i_level - 1l; i >= 1l; --i) {
+		memcpy(&next[0l], &heap->nodes[i * width], width);
+		do_dary_bheap_shift(heap->nodes, &next[0l], width, i, length,
+				    build.log_arity, compare);
+	}
+
+	heap->count = length;
+
+	bheap_stats_count(heap);
+
+	return heap;
+}
+
+struct BHeap *parray_into_bheap(const void *const array,
+				const size_t length,
+				const size_t width,
+				int (*compare)(const void *,
+					       const void *))
+{
+	return parray_into_dary_bheap(array, length, width, BHEAP_ARITY, 0ul,
+				      compare);
+}
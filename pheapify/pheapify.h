@@ -0,0 +1,47 @@
+#ifndef PHEAPIFY_PHEAPIFY_H_
+#define PHEAPIFY_PHEAPIFY_H_
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE */
+#include <bheap/bheap.h>	/* struct BHeap, array_into_dary_bheap */
+
+/*			- pheapify.h -
+ * multi-threaded 'array_into_bheap', for arrays too large for one core
+ *
+ * 1. the input is copied into the heap's nodes in 'count_threads' chunks, one
+ *    per thread (which also spreads first touch of the pages)
+ * 2. the first level of the heap holding at least PHEAPIFY_ROOTS_PER_THREAD
+ *    nodes per thread is picked, and the subtrees below its nodes are handed
+ *    out to the threads one at a time.  Subtrees are disjoint, so each is
+ *    heapified on its own: Floyd, level by level from its lowest parents up.
+ * 3. the few levels above them are heapified serially
+ *
+ * Each node is still shifted down only after every node below it, and nothing
+ * outside its subtree is touched meanwhile, so the result is node-for-node the
+ * heap 'array_into_dary_bheap' builds.
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ */
+
+/* heaps smaller than this are not worth a thread */
+#define PHEAPIFY_MIN_LENGTH	  65536ul
+
+/* subtrees handed out per thread, for balance (subtrees reaching past the
+ * last, partial level are smaller) */
+#define PHEAPIFY_ROOTS_PER_THREAD 16ul
+
+/* copies 'array' into a new 'arity'-ary heap and heapifies it with up to
+ * 'count_threads' threads (0 for one per online processor) */
+struct BHeap *parray_into_dary_bheap(const void *const array,
+				     const size_t length,
+				     const size_t width,
+				     const size_t arity,
+				     const size_t count_threads,
+				     int (*compare)(const void *,
+						    const void *));
+
+/* as 'array_into_bheap', with one thread per online processor */
+struct BHeap *parray_into_bheap(const void *const array,
+				const size_t length,
+				const size_t width,
+				int (*compare)(const void *,
+					       const void *));
+#endif /* ifndef PHEAPIFY_PHEAPIFY_H_ */
@@ -0,0 +1,290 @@
+#define _POSIX_C_SOURCE 200809L	/* sysconf */
+#include <pthread.h>		/* pthread_create, pthread_join */
+#include <unistd.h>		/* sysconf */
+#include <psort/psort.h>
+
+struct PSort {
+	char *array;
+	char *buffer;		/* merge output, 'length * width' bytes */
+	size_t length;
+	size_t width;
+	size_t count;		/* count of chunks == slices == threads */
+	size_t *bounds;		/* per chunk, 'count + 1' slice boundaries */
+	int (*compare)(const void *,
+		       const void *);
+};
+
+struct PSortJob {
+	pthread_t thread;
+	struct PSort *sort;
+	size_t index;
+};
+
+/* head of a sorted run, ordered in the tournament by its next node */
+struct Cursor {
+	const char *head;
+	const char *end;
+	int (*compare)(const void *,
+		       const void *);
+};
+
+static int compare_cursor(const void *x,
+			  const void *y)
+{
+	const struct Cursor *const cx = (const struct Cursor *) x;
+
+	return cx->compare(cx->head, ((const struct Cursor *) y)->head);
+}
+
+static inline size_t chunk_start(const struct PSort *sort,
+				 const size_t chunk)
+{
+	return (sort->length * chunk) / sort->count;
+}
+
+static inline size_t *chunk_bounds(const struct PSort *sort,
+				   const size_t chunk)
+{
+	return &sort->bounds[chunk * (sort->count + 1ul)];
+}
+
+/* first index of the output range written by slice 'slice' */
+static inline size_t slice_start(const struct PSort *sort,
+				 const size_t slice)
+{
+	size_t start = 0ul;
+	size_t *bounds;
+
+	for (size_t c = 0ul; c < sort->count; ++c) {
+		bounds = chunk_bounds(sort, c);
+		start += bounds[slice] - bounds[0l];
+	}
+
+	return start;
+}
+
+
+/* thread routines
+ ******************************************************************************/
+static void *sort_chunk(void *arg)
+{
+	const struct PSortJob *const job = (const struct PSortJob *) arg;
+	const struct PSort *const sort	 = job->sort;
+	const size_t start = chunk_start(sort, job->index);
+
+	bheap_sort(&sort->array[start * sort->width],
+		   chunk_start(sort, job->index + 1ul) - start,
+		   sort->width,
+		   sort->compare);
+
+	return NULL;
+}
+
+static void *merge_slice(void *arg)
+{
+	const struct PSortJob *const job = (const struct PSortJob *) arg;
+	const struct PSort *const sort	 = job->sort;
+	const size_t width		 = sort->width;
+	char *out = &sort->buffer[slice_start(sort, job->index) * width];
+	struct BHeap *tournament;
+	struct Cursor next, *top;
+	size_t *bounds;
+
+	tournament = init_sized_dary_bheap(sizeof(struct Cursor), sort->count,
+					   2ul, &compare_cursor);
+
+	next.compare = sort->compare;
+
+	for (size_t c = 0ul; c < sort->count; ++c) {
+		bounds	  = chunk_bounds(sort, c);
+		next.head = &sort->array[bounds[job->index]	  * width];
+		next.end  = &sort->array[bounds[job->index + 1ul] * width];
+
+		if (next.head < next.end)
+			bheap_insert(tournament, &next);
+	}
+
+	while (tournament->count > 1ul) {
+		top = (struct Cursor *) &tournament->nodes[tournament->width];
+
+		memcpy(out, top->head, width);
+		out += width;
+
+		next	   = *top;
+		next.head += width;
+
+		if (next.head == next.end)
+			(void) bheap_extract(tournament);
+		else
+			do_bheap_shift(tournament->nodes, &next,
+				       tournament->width, 1l,
+				       tournament->count, &compare_cursor);
+	}
+
+	/* last run standing */
+	if (tournament->count == 1ul) {
+		top = (struct Cursor *) &tournament->nodes[tournament->width];
+		memcpy(out, top->head, top->end - top->head);
+	}
+
+	free_bheap(tournament);
+
+	return NULL;
+}
+
+static void *copy_back(void *arg)
+{
+	const struct PSortJob *const job = (const struct PSortJob *) arg;
+	const struct PSort *const sort	 = job->sort;
+	const size_t start = chunk_start(sort, job->index) * sort->width;
+	const size_t end   = chunk_start(sort, job->index + 1ul) * sort->width;
+
+	memcpy(&sort->array[start], &sort->buffer[start], end - start);
+
+	return NULL;
+}
+
+/* runs 'routine' for every job, job 0 on the calling thread */
+static void run_jobs(struct PSortJob *jobs,
+		     const size_t count,
+		     void *(*routine)(void *))
+{
+	for (size_t i = 1ul; i < count; ++i)
+		if (pthread_create(&jobs[i].thread, NULL, routine,
+				   &jobs[i]) != 0)
+			EXIT_ON_FAILURE("failed to create thread %lu", i);
+
+	(void) routine(&jobs[0l]);
+
+	for (size_t i = 1ul; i < count; ++i)
+		pthread_join(jobs[i].thread, NULL);
+}
+
+
+/* splitting
+ ******************************************************************************/
+/* first index in [i_from, i_until) whose node does not belong above
+ * 'splitter' */
+static size_t lower_bound(const struct PSort *sort,
+			  size_t i_from,
+			  size_t i_until,
+			  const void *const splitter)
+{
+	size_t i_mid;
+
+	while (i_from < i_until) {
+		i_mid = i_from + ((i_until - i_from) / 2ul);
+
+		if (sort->compare(&sort->array[i_mid * sort->width], splitter))
+			i_from = i_mid + 1ul;
+		else
+			i_until = i_mid;
+	}
+
+	return i_from;
+}
+
+/* regular sampling: 'count - 1' evenly spaced nodes per sorted chunk, sorted,
+ * yield 'count - 1' evenly spaced splitters cutting every chunk */
+static void split_chunks(struct PSort *sort)
+{
+	const size_t count	   = sort->count;
+	const size_t width	   = sort->width;
+	const size_t count_samples = count * (count - 1ul);
+	size_t start, length, *bounds;
+	char *samples, *sample;
+
+	HANDLE_MALLOC(samples, width * count_samples);
+
+	sample = samples;
+
+	for (size_t c = 0ul; c < count; ++c) {
+		start  = chunk_start(sort, c);
+		length = chunk_start(sort, c + 1ul) - start;
+
+		for (size_t k = 1ul; k < count; ++k) {
+			memcpy(sample,
+			       &sort->array[(start + ((length * k) / count))
+					    * width],
+			       width);
+			sample += width;
+		}
+	}
+
+	bheap_sort(samples, count_samples, width, sort->compare);
+
+	for (size_t c = 0ul; c < count; ++c) {
+		bounds = chunk_bounds(sort, c);
+
+		bounds[0l]    = chunk_start(sort, c);
+		bounds[count] = chunk_start(sort, c + 1ul);
+
+		for (size_t j = 1ul; j < count; ++j)
+			bounds[j] = lower_bound(sort, bounds[j - 1ul],
+						bounds[count],
+						&samples[((count_samples * j)
+							  / count) * width]);
+	}
+
+	free(samples);
+}
+
+
+/* sorting
+ ******************************************************************************/
+void bheap_psort_threads(void *const array,
+			 const size_t length,
+			 const size_t width,
+			 const size_t count_threads,
+			 int (*compare)(const void *,
+					const void *))
+{
+	struct PSort sort;
+	struct PSortJob *jobs;
+	size_t count = (count_threads == 0ul)
+		     ? (size_t) sysconf(_SC_NPROCESSORS_ONLN)
+		     : count_threads;
+
+	if (count > (length / PSORT_MIN_CHUNK))
+		count = length / PSORT_MIN_CHUNK;
+
+	if (count < 2ul) {
+		bheap_sort(array, length, width, compare);
+		return;
+	}
+
+	sort.array   = (char *) array;
+	sort.length  = length;
+	sort.width   = width;
+	sort.count   = count;
+	sort.compare = compare;
+
+	HANDLE_MALLOC(sort.buffer, width * length);
+	HANDLE_MALLOC(sort.bounds, sizeof(size_t) * count * (count + 1ul));
+	HANDLE_MALLOC(jobs,	   sizeof(struct PSortJob) * count);
+
+	for (size_t i = 0ul; i < count; ++i) {
+		jobs[i].sort  = &sort;
+		jobs[i].index = i;
+	}
+
+	run_jobs(jobs, count, &sort_chunk);
+
+	split_chunks(&sort);
+
+	run_jobs(jobs, count, &merge_slice);
+	run_jobs(jobs, count, &copy_back);
+
+	free(jobs);
+	free(sort.bounds);
+	free(sort.buffer);
+}
+
+void bheap_psort(void *const array,
+		 const size_t length,
+		 const size_t width,
+		 int (*compare)(const void *,
+				const void *))
+{
+	bheap_psort_threads(array, length, width, 0ul, compare);
+}
@@ -0,0 +1,41 @@
+#ifndef PSORT_PSORT_H_
+#define PSORT_PSORT_H_
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE */
+#include <bheap/bheap.h>	/* bheap_sort, struct BHeap */
+
+/*			- psort.h -
+ * multi-threaded sort over the heap code, for arrays too large for one core
+ *
+ * 1. the input is cut into 'count_threads' chunks, each heapsorted by its own
+ *    thread ('bheap_sort')
+ * 2. regular samples of the sorted chunks pick 'count_threads - 1' splitters,
+ *    and each chunk is cut at the splitters by binary search
+ * 3. thread 'j' tournament-merges the 'j'th slice of every chunk (a 'struct
+ *    BHeap' of run cursors) into its own range of a scratch buffer
+ * 4. the buffer is copied back in parallel
+ *
+ * The result is in extraction order, as from 'bheap_sort'.  The sort is not
+ * stable.  A scratch buffer of 'length * width' bytes is allocated.
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ */
+
+/* chunks smaller than this are not worth a thread */
+#define PSORT_MIN_CHUNK 8192ul
+
+/* sorts 'array' with up to 'count_threads' threads (0 for one per online
+ * processor) */
+void bheap_psort_threads(void *const array,
+			 const size_t length,
+			 const size_t width,
+			 const size_t count_threads,
+			 int (*compare)(const void *,
+					const void *));
+
+/* drop-in for 'bheap_sort', with one thread per online processor */
+void bheap_psort(void *const array,
+		 const size_t length,
+		 const size_t width,
+		 int (*compare)(const void *,
+				const void *));
+#endif /* ifndef PSORT_PSORT_H_ */
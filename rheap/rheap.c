@@ -0,0 +1,107 @@
+#include <rheap/rheap.h>
+
+/* index math
+ ******************************************************************************/
+extern inline unsigned int rheap_bucket(const uint64_t last,
+					const uint64_t key);
+
+extern inline uint64_t rheap_key(const struct RHeap *heap,
+				 const void *const node);
+
+
+/* initialize, destroy
+ ******************************************************************************/
+extern inline struct RHeap *init_rheap(const size_t width,
+				       const size_t key_width);
+
+extern inline void clear_rheap(struct RHeap *heap);
+
+extern inline void free_rheap(struct RHeap *heap);
+
+
+static inline void bucket_push(struct RHeapBucket *bucket,
+			       const void *const next,
+			       const size_t width)
+{
+	if (bucket->count == bucket->alloc) {
+		bucket->alloc = (bucket->alloc == 0ul)
+			      ? 16ul
+			      : (bucket->alloc * 2ul);
+
+		HANDLE_REALLOC(bucket->nodes, width * bucket->alloc);
+	}
+
+	memcpy(&bucket->nodes[bucket->count * width], next, width);
+	++(bucket->count);
+}
+
+
+/* insertion
+ ******************************************************************************/
+void rheap_insert(struct RHeap *heap,
+		  const void *const next)
+{
+	const uint64_t key = rheap_key(heap, next);
+
+	if (key < heap->last)
+		EXIT_ON_FAILURE("key (%lu) below last extracted key (%lu)",
+				key, heap->last);
+
+	bucket_push(&heap->buckets[rheap_bucket(heap->last, key)], next,
+		    heap->width);
+
+	++(heap->count);
+}
+
+
+/* extraction
+ ******************************************************************************/
+/* empties the lowest non-empty bucket into lower buckets around its smallest
+ * key, which becomes 'last' */
+static void redistribute(struct RHeap *heap)
+{
+	const size_t width = heap->width;
+	struct RHeapBucket *bucket = &heap->buckets[1l];
+	const char *node, *end;
+	uint64_t key, min;
+
+	while (bucket->count == 0ul)
+		++bucket;
+
+	end = &bucket->nodes[bucket->count * width];
+	min = rheap_key(heap, bucket->nodes);
+
+	for (node = &bucket->nodes[width]; node < end; node += width) {
+		key = rheap_key(heap, node);
+
+		if (key < min)
+			min = key;
+	}
+
+	heap->last = min;
+
+	/* every node lands in a strictly lower bucket */
+	for (node = bucket->nodes; node < end; node += width)
+		bucket_push(&heap->buckets[rheap_bucket(min,
+							rheap_key(heap,
+								  node))],
+			    node, width);
+
+	bucket->count = 0ul;
+}
+
+void *rheap_extract(struct RHeap *heap)
+{
+	struct RHeapBucket *const equal = &heap->buckets[0l];
+
+	if (heap->count == 0ul)
+		return NULL;
+
+	if (equal->count == 0ul)
+		redistribute(heap);
+
+	--(equal->count);
+	--(heap->count);
+
+	return &equal->nodes[equal->count * heap->width];
+}
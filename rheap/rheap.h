@@ -0,0 +1,120 @@
+#ifndef RHEAP_RHEAP_H_
+#define RHEAP_RHEAP_H_
+#include <stdint.h>		/* uint64_t */
+#include <utils/utils.h>	/* HANDLE_MALLOC, HANDLE_REALLOC */
+
+/*			- rheap.h -
+ * radix heap for monotone integer keys
+ *
+ * Nodes of 'width' bytes lead with an unsigned integer key of 'key_width'
+ * (4 or 8) bytes, followed by any payload.  Extracted keys must never
+ * decrease: every inserted key must be at least the last extracted key.
+ *
+ * Bucket 'b' holds nodes whose key first differs from the last extracted key
+ * at bit 'b - 1' (bucket 0: equal keys).  Extraction pops bucket 0; when it is
+ * empty the lowest non-empty bucket is emptied into lower buckets around its
+ * smallest key, so each node moves at most 'key bits' times over its life and
+ * no key comparisons are made between nodes beyond the scan for that minimum.
+ */
+
+#define RHEAP_COUNT_BUCKETS 65u
+
+struct RHeapBucket {
+	size_t count;		/* count of occupied nodes */
+	size_t alloc;		/* count of allocated nodes */
+	char *nodes;
+};
+
+struct RHeap {
+	size_t count;		/* count of occupied nodes */
+	size_t width;		/* byte size per node */
+	size_t key_width;	/* byte size of the leading key: 4 or 8 */
+	uint64_t last;		/* last extracted key */
+	struct RHeapBucket buckets[RHEAP_COUNT_BUCKETS];
+};
+
+/* index math
+ ******************************************************************************/
+/* 1 + position of the highest bit where 'key' differs from 'last', 0 if none */
+inline unsigned int rheap_bucket(const uint64_t last,
+				 const uint64_t key)
+{
+	return (key == last) ? 0u : (64u - __builtin_clzll(key ^ last));
+}
+
+inline uint64_t rheap_key(const struct RHeap *heap,
+			  const void *const node)
+{
+	uint32_t key32;
+	uint64_t key64;
+
+	if (heap->key_width == sizeof(uint32_t)) {
+		memcpy(&key32, node, sizeof(uint32_t));
+		return key32;
+	}
+
+	memcpy(&key64, node, sizeof(uint64_t));
+	return key64;
+}
+
+
+/* initialize, destroy
+ ******************************************************************************/
+inline struct RHeap *init_rheap(const size_t width,
+				const size_t key_width)
+{
+	struct RHeap *heap;
+
+	if (((key_width != sizeof(uint32_t)) && (key_width != sizeof(uint64_t)))
+	    || (width < key_width))
+		EXIT_ON_FAILURE("key width (%lu) must be 4 or 8 and fit in "
+				"node width (%lu)", key_width, width);
+
+	HANDLE_MALLOC(heap, sizeof(struct RHeap));
+
+	heap->count	= 0ul;
+	heap->width	= width;
+	heap->key_width = key_width;
+	heap->last	= 0lu;
+
+	for (unsigned int b = 0u; b < RHEAP_COUNT_BUCKETS; ++b) {
+		heap->buckets[b].count = 0ul;
+		heap->buckets[b].alloc = 0ul;
+		heap->buckets[b].nodes = NULL;
+	}
+
+	return heap;
+}
+
+/* empties 'heap' and resets the monotone bound to 0 */
+inline void clear_rheap(struct RHeap *heap)
+{
+	for (unsigned int b = 0u; b < RHEAP_COUNT_BUCKETS; ++b)
+		heap->buckets[b].count = 0ul;
+
+	heap->count = 0ul;
+	heap->last  = 0lu;
+}
+
+inline void free_rheap(struct RHeap *heap)
+{
+	for (unsigned int b = 0u; b < RHEAP_COUNT_BUCKETS; ++b)
+		free(heap->buckets[b].nodes);
+
+	free(heap);
+}
+
+
+/* insertion
+ ******************************************************************************/
+/* 'next' must lead with a key no less than the last extracted key */
+void rheap_insert(struct RHeap *heap,
+		  const void *const next);
+
+
+/* extraction
+ ******************************************************************************/
+/* returns a pointer to the extracted node (smallest key, ties in any order),
+ * valid until the next call that modifies 'heap', or NULL if empty */
+void *rheap_extract(struct RHeap *heap);
+#endif /* ifndef RHEAP_RHEAP_H_ */
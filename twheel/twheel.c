@@ -0,0 +1,431 @@
+#include <twheel/twheel.h>
+
+#define SLOT_MASK ((uint64_t) (TWHEEL_SLOTS - 1u))
+
+/* ticks spanned by a slot of the top level: far timers are pulled into the
+ * wheel at each multiple */
+#define TOP_SPAN (1lu << (TWHEEL_BITS * (TWHEEL_LEVELS - 1u)))
+
+/* overflow heap node */
+struct Far {
+	uint64_t deadline;
+	size_t handle;
+};
+
+static int compare_far(const void *x,
+		       const void *y)
+{
+	return ((const struct Far *) x)->deadline
+	     < ((const struct Far *) y)->deadline;
+}
+
+/* slot for 'deadline' ('deadline - now < TWHEEL_HORIZON'): the level whose
+ * slot span is the greatest not exceeding the time remaining, hashed by the
+ * deadline's digit at that level */
+static inline unsigned int slot_of(const uint64_t now,
+				   const uint64_t deadline)
+{
+	const uint64_t delta = deadline - now;
+	const unsigned int level = (delta < TWHEEL_SLOTS)
+				 ? 0u
+				 : ((63u - __builtin_clzll(delta))
+				    / TWHEEL_BITS);
+
+	return (level * TWHEEL_SLOTS)
+	     + ((deadline >> (TWHEEL_BITS * level)) & SLOT_MASK);
+}
+
+
+/* slab, slot lists
+ ******************************************************************************/
+static size_t acquire_handle(struct TWheel *wheel)
+{
+	if (wheel->count_free > 0ul)
+		return wheel->free_handles[--(wheel->count_free)];
+
+	if (wheel->count_used == wheel->alloc) {
+		wheel->alloc *= 2ul;
+		HANDLE_REALLOC(wheel->timers,
+			       sizeof(struct TWheelTimer) * wheel->alloc);
+		HANDLE_REALLOC(wheel->free_handles,
+			       sizeof(size_t) * wheel->alloc);
+	}
+
+	return (wheel->count_used)++;
+}
+
+static inline void release_handle(struct TWheel *wheel,
+				  const size_t handle)
+{
+	wheel->timers[handle].slot = TWHEEL_SLOT_FREE;
+	wheel->free_handles[(wheel->count_free)++] = handle;
+}
+
+static inline void link_timer(struct TWheel *wheel,
+			      const size_t handle,
+			      const unsigned int slot)
+{
+	struct TWheelTimer *const timer = &wheel->timers[handle];
+	const size_t head		= wheel->heads[slot];
+
+	timer->slot = slot;
+	timer->prev = TWHEEL_NULL_HANDLE;
+	timer->next = head;
+
+	if (head != TWHEEL_NULL_HANDLE)
+		wheel->timers[head].prev = handle;
+
+	wheel->heads[slot] = handle;
+	wheel->occupied[slot / TWHEEL_SLOTS] |= 1lu << (slot & SLOT_MASK);
+	++(wheel->count_wheel);
+}
+
+static inline void unlink_timer(struct TWheel *wheel,
+				const size_t handle)
+{
+	struct TWheelTimer *const timer = &wheel->timers[handle];
+	const unsigned int slot		= timer->slot;
+
+	if (timer->prev == TWHEEL_NULL_HANDLE)
+		wheel->heads[slot] = timer->next;
+	else
+		wheel->timers[timer->prev].next = timer->next;
+
+	if (timer->next != TWHEEL_NULL_HANDLE)
+		wheel->timers[timer->next].prev = timer->prev;
+
+	if (wheel->heads[slot] == TWHEEL_NULL_HANDLE)
+		wheel->occupied[slot / TWHEEL_SLOTS] &=
+			~(1lu << (slot & SLOT_MASK));
+
+	--(wheel->count_wheel);
+}
+
+static void place_timer(struct TWheel *wheel,
+			const size_t handle)
+{
+	struct Far far = {
+		.deadline = wheel->timers[handle].deadline,
+		.handle	  = handle
+	};
+
+	if ((far.deadline - wheel->now) < TWHEEL_HORIZON) {
+		link_timer(wheel, handle, slot_of(wheel->now, far.deadline));
+	} else {
+		wheel->timers[handle].slot = TWHEEL_SLOT_OVERFLOW;
+		bheap_insert(wheel->overflow, &far);
+	}
+}
+
+
+/* overflow heap
+ ******************************************************************************/
+/* drops cancelled timers from the top of 'overflow' */
+static void prune_overflow(struct TWheel *wheel)
+{
+	struct BHeap *const overflow = wheel->overflow;
+	const struct Far *root;
+
+	while (overflow->count > 0ul) {
+		root = (const struct Far *) &overflow->nodes[overflow->width];
+
+		if (wheel->timers[root->handle].slot != TWHEEL_SLOT_CANCELLED)
+			return;
+
+		release_handle(wheel, root->handle);
+		--(wheel->count_dead);
+		(void) bheap_extract(overflow);
+	}
+}
+
+/* drops every cancelled timer once they outnumber the live ones */
+static void compact_overflow(struct TWheel *wheel)
+{
+	struct BHeap *const overflow = wheel->overflow;
+	const size_t width	     = overflow->width;
+	const struct Far *far;
+	size_t i_keep = 0ul;
+
+	if ((wheel->count_dead * 2ul) <= overflow->count)
+		return;
+
+	for (size_t i = 1ul; i <= overflow->count; ++i) {
+		far = (const struct Far *) &overflow->nodes[i * width];
+
+		if (wheel->timers[far->handle].slot == TWHEEL_SLOT_CANCELLED)
+			release_handle(wheel, far->handle);
+		else if (++i_keep < i)
+			memcpy(&overflow->nodes[i_keep * width], far, width);
+	}
+
+	overflow->count	 = i_keep;
+	wheel->count_dead = 0ul;
+
+	do_bheap_heapify(overflow->nodes, 1l, i_keep, width,
+			 overflow->log_arity, overflow->compare);
+}
+
+/* moves far timers now within the horizon into the wheel */
+static void pull_overflow(struct TWheel *wheel)
+{
+	struct BHeap *const overflow = wheel->overflow;
+	const struct Far *root;
+
+	prune_overflow(wheel);
+
+	while (overflow->count > 0ul) {
+		root = (const struct Far *) &overflow->nodes[overflow->width];
+
+		if ((root->deadline - wheel->now) >= TWHEEL_HORIZON)
+			return;
+
+		link_timer(wheel, root->handle,
+			   slot_of(wheel->now, root->deadline));
+		(void) bheap_extract(overflow);
+
+		prune_overflow(wheel);
+	}
+}
+
+
+/* initialize, destroy
+ ******************************************************************************/
+struct TWheel *init_twheel(const uint64_t now)
+{
+	struct TWheel *wheel;
+
+	HANDLE_MALLOC(wheel, sizeof(struct TWheel));
+	HANDLE_MALLOC(wheel->timers,
+		      sizeof(struct TWheelTimer) * BHEAP_DEFAULT_ALLOC);
+	HANDLE_MALLOC(wheel->free_handles,
+		      sizeof(size_t) * BHEAP_DEFAULT_ALLOC);
+
+	wheel->now	   = now;
+	wheel->count	   = 0ul;
+	wheel->count_wheel = 0ul;
+	wheel->count_dead  = 0ul;
+	wheel->alloc	   = BHEAP_DEFAULT_ALLOC;
+	wheel->count_used  = 0ul;
+	wheel->count_free  = 0ul;
+	wheel->overflow	   = init_bheap(sizeof(struct Far), &compare_far);
+
+	for (unsigned int l = 0u; l < TWHEEL_LEVELS; ++l)
+		wheel->occupied[l] = 0lu;
+
+	for (unsigned int s = 0u; s < (TWHEEL_LEVELS * TWHEEL_SLOTS); ++s)
+		wheel->heads[s] = TWHEEL_NULL_HANDLE;
+
+	return wheel;
+}
+
+void free_twheel(struct TWheel *wheel)
+{
+	free_bheap(wheel->overflow);
+	free(wheel->free_handles);
+	free(wheel->timers);
+	free(wheel);
+}
+
+
+/* arm, cancel
+ ******************************************************************************/
+size_t twheel_arm(struct TWheel *wheel,
+		  const uint64_t deadline,
+		  void *const data)
+{
+	const size_t handle = acquire_handle(wheel);
+	struct TWheelTimer *const timer = &wheel->timers[handle];
+
+	timer->deadline = (deadline > wheel->now) ? deadline : (wheel->now + 1lu);
+	timer->data	= data;
+
+	place_timer(wheel, handle);
+	++(wheel->count);
+
+	return handle;
+}
+
+bool twheel_cancel(struct TWheel *wheel,
+		   const size_t handle)
+{
+	if (handle >= wheel->count_used)
+		return false;
+
+	switch (wheel->timers[handle].slot) {
+	case TWHEEL_SLOT_FREE:
+	case TWHEEL_SLOT_CANCELLED:
+		return false;
+
+	case TWHEEL_SLOT_OVERFLOW:
+		wheel->timers[handle].slot = TWHEEL_SLOT_CANCELLED;
+		++(wheel->count_dead);
+		compact_overflow(wheel);
+		break;
+
+	default:
+		unlink_timer(wheel, handle);
+		release_handle(wheel, handle);
+	}
+
+	--(wheel->count);
+
+	return true;
+}
+
+size_t twheel_rearm(struct TWheel *wheel,
+		    const size_t handle,
+		    const uint64_t deadline)
+{
+	if (handle >= wheel->count_used)
+		EXIT_ON_FAILURE("timer %lu is not armed", handle);
+
+	struct TWheelTimer *const timer = &wheel->timers[handle];
+	const uint64_t next = (deadline > wheel->now)
+			    ? deadline
+			    : (wheel->now + 1lu);
+
+	if (timer->slot == TWHEEL_SLOT_OVERFLOW) {
+		void *const data = timer->data;
+
+		(void) twheel_cancel(wheel, handle);
+
+		return twheel_arm(wheel, next, data);
+	}
+
+	if (timer->slot >= TWHEEL_SLOT_OVERFLOW)
+		EXIT_ON_FAILURE("timer %lu is not armed", handle);
+
+	/* later: leave it to be re-hung when its slot comes due */
+	if (next < timer->deadline) {
+		unlink_timer(wheel, handle);
+		timer->deadline = next;
+		place_timer(wheel, handle);
+	} else {
+		timer->deadline = next;
+	}
+
+	return handle;
+}
+
+
+/* advance
+ ******************************************************************************/
+/* re-hangs every timer of the current slot of 'level' by its deadline (one
+ * level finer, unless pushed later by 'twheel_rearm') */
+static void cascade(struct TWheel *wheel,
+		    const unsigned int level)
+{
+	const unsigned int slot = (level * TWHEEL_SLOTS)
+				+ ((wheel->now >> (TWHEEL_BITS * level))
+				   & SLOT_MASK);
+	size_t handle = wheel->heads[slot];
+	size_t next;
+
+	wheel->heads[slot] = TWHEEL_NULL_HANDLE;
+	wheel->occupied[level] &= ~(1lu << (slot & SLOT_MASK));
+
+	for (; handle != TWHEEL_NULL_HANDLE; handle = next) {
+		next = wheel->timers[handle].next;
+		--(wheel->count_wheel);
+		place_timer(wheel, handle);
+	}
+}
+
+/* fires every timer of level 0 slot 'slot' that is due, re-hanging those
+ * pushed later by 'twheel_rearm' */
+static size_t expire_slot(struct TWheel *wheel,
+			  const unsigned int slot,
+			  TWheelExpire expire,
+			  void *context)
+{
+	size_t count = 0ul;
+	size_t handle;
+	void *data;
+
+	/* take from the head each time: 'expire' may cancel any timer */
+	while ((handle = wheel->heads[slot]) != TWHEEL_NULL_HANDLE) {
+		data = wheel->timers[handle].data;
+
+		unlink_timer(wheel, handle);
+
+		if (wheel->timers[handle].deadline > wheel->now) {
+			place_timer(wheel, handle);
+			continue;
+		}
+
+		release_handle(wheel, handle);
+		--(wheel->count);
+		++count;
+
+		expire(context, handle, data);
+	}
+
+	return count;
+}
+
+size_t twheel_advance(struct TWheel *wheel,
+		      const uint64_t now,
+		      TWheelExpire expire,
+		      void *context)
+{
+	size_t count = 0ul;
+	uint64_t tick, later;
+	const struct Far *root;
+
+	while (wheel->now < now) {
+		/* nothing hangs in the wheel: skip to just short of the
+		 * earliest far deadline */
+		if (wheel->count_wheel == 0ul) {
+			prune_overflow(wheel);
+
+			tick = now;
+
+			if (wheel->overflow->count > 0ul) {
+				root = (const struct Far *)
+				       &wheel->overflow->nodes[wheel->overflow->width];
+
+				if ((root->deadline - 1lu) < tick)
+					tick = root->deadline - 1lu;
+			}
+
+			wheel->now = tick;
+			pull_overflow(wheel);
+			continue;
+		}
+
+		/* next tick with work: an occupied level 0 slot later in this
+		 * turn, or else the start of the next turn */
+		later = ((wheel->now & SLOT_MASK) == SLOT_MASK)
+		      ? 0lu
+		      : (wheel->occupied[0] & (~0lu << ((wheel->now & SLOT_MASK)
+							+ 1lu)));
+		tick  = (later != 0lu)
+		      ? ((wheel->now & ~SLOT_MASK) + __builtin_ctzll(later))
+		      : ((wheel->now | SLOT_MASK) + 1lu);
+
+		if (tick > now) {
+			wheel->now = now;
+			break;
+		}
+
+		wheel->now = tick;
+
+		if ((tick & SLOT_MASK) == 0lu) {
+			for (unsigned int l = 1u; l < TWHEEL_LEVELS; ++l) {
+				cascade(wheel, l);
+
+				if (((tick >> (TWHEEL_BITS * l)) & SLOT_MASK)
+				    != 0lu)
+					break;
+			}
+
+			if ((tick % TOP_SPAN) == 0lu)
+				pull_overflow(wheel);
+		}
+
+		count += expire_slot(wheel, (unsigned int) (tick & SLOT_MASK),
+				     expire, context);
+	}
+
+	return count;
+}
@@ -0,0 +1,104 @@
+#ifndef TWHEEL_TWHEEL_H_
+#define TWHEEL_TWHEEL_H_
+#include <stdbool.h>		/* bool */
+#include <stdint.h>		/* uint64_t */
+#include <utils/utils.h>	/* HANDLE_MALLOC, HANDLE_REALLOC */
+#include <bheap/bheap.h>	/* struct BHeap */
+
+/*			- twheel.h -
+ * hierarchical timer wheel with a heap for far deadlines
+ *
+ * Time is an integer tick count.  A timer due within TWHEEL_HORIZON ticks
+ * hangs in a slot of one of TWHEEL_LEVELS hashed wheels of TWHEEL_SLOTS slots
+ * (level 'l' slots span TWHEEL_SLOTS^l ticks), on an intrusive list threaded
+ * through a stable slab of timers, so arming and cancelling are O(1).  As the
+ * wheel turns past a level boundary, the slot of the level above is cascaded
+ * into finer slots.  Timers due further out wait in a 'struct BHeap' ordered
+ * by deadline and are moved into the wheel once within the horizon;
+ * cancelling one of those only marks it, and the heap drops such timers as
+ * they surface (or all at once when they outnumber the live ones).
+ *
+ * Timers are named by the handle returned from 'twheel_arm', which is
+ * released when the timer fires or is cancelled.
+ *
+ * Pushing a timer's deadline later with 'twheel_rearm' (a reset on activity)
+ * only updates the timer: it stays in its slot, and when that slot comes due
+ * it is hung again by its new deadline instead of firing.
+ */
+
+#define TWHEEL_NULL_HANDLE ((size_t) -1)
+
+#define TWHEEL_BITS    6u
+#define TWHEEL_SLOTS   (1u << TWHEEL_BITS)
+#define TWHEEL_LEVELS  4u
+#define TWHEEL_HORIZON (1lu << (TWHEEL_BITS * TWHEEL_LEVELS))
+
+/* called once per fired timer, after its handle has been released (so it may
+ * arm and cancel timers freely) */
+typedef void (*TWheelExpire)(void *context,
+			     const size_t handle,
+			     void *data);
+
+struct TWheelTimer {
+	uint64_t deadline;
+	void *data;
+	size_t next;		/* neighbours in its slot list */
+	size_t prev;
+	unsigned int slot;	/* (level * TWHEEL_SLOTS) + index, or below */
+};
+
+/* 'slot' of timers not hanging in the wheel */
+#define TWHEEL_SLOT_OVERFLOW  (TWHEEL_LEVELS * TWHEEL_SLOTS)
+#define TWHEEL_SLOT_CANCELLED (TWHEEL_SLOT_OVERFLOW + 1u)
+#define TWHEEL_SLOT_FREE      (TWHEEL_SLOT_OVERFLOW + 2u)
+
+struct TWheel {
+	uint64_t now;		/* last tick processed */
+	size_t count;		/* count of armed timers */
+	size_t count_wheel;	/* of which hanging in the wheel */
+	size_t count_dead;	/* cancelled timers still in 'overflow' */
+	size_t alloc;		/* count of timers in the slab */
+	size_t count_used;	/* handles ever handed out */
+	size_t count_free;	/* count of released handles */
+	struct TWheelTimer *timers;
+	size_t *free_handles;	/* stack of released handles */
+	struct BHeap *overflow;	/* (deadline, handle), earliest first */
+	uint64_t occupied[TWHEEL_LEVELS];	/* bit per non-empty slot */
+	size_t heads[TWHEEL_LEVELS * TWHEEL_SLOTS];
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+struct TWheel *init_twheel(const uint64_t now);
+
+void free_twheel(struct TWheel *wheel);
+
+
+/* arm, cancel
+ ******************************************************************************/
+/* arms a timer firing on the first advance to or past 'deadline' (at the
+ * next tick if 'deadline' has passed) and returns its handle */
+size_t twheel_arm(struct TWheel *wheel,
+		  const uint64_t deadline,
+		  void *const data);
+
+/* disarms the timer named by 'handle', returning false if it is not armed */
+bool twheel_cancel(struct TWheel *wheel,
+		   const size_t handle);
+
+/* moves the armed timer named by 'handle' to 'deadline', returning its handle
+ * (a new one only if it was waiting in the overflow heap) */
+size_t twheel_rearm(struct TWheel *wheel,
+		    const size_t handle,
+		    const uint64_t deadline);
+
+
+/* advance
+ ******************************************************************************/
+/* moves time forward to 'now', firing every timer due by then through
+ * 'expire', and returns the count fired */
+size_t twheel_advance(struct TWheel *wheel,
+		      const uint64_t now,
+		      TWheelExpire expire,
+		      void *context);
+#endif /* ifndef TWHEEL_TWHEEL_H_ */
@@ -2,8 +2,12 @@
 #include <string.h> /* memcpy */
 #include <utils/rand.h>
 
+pcg32_random_t _RNG = PCG32_INITIALIZER;
+
 extern inline void init_rng(void);
 
+extern inline void seed_rng(const uint64_t seed);
+
 extern inline bool coin_flip(void);
 
 extern inline uint32_t rand_uint_upto(const uint32_t rbound);
@@ -16,10 +20,10 @@ extern inline double rand_dbl_upto(const double rbound);
 extern inline double rand_in_dbl_range(const double lbound,
 				       const double rbound);
 
-inline void swap_els(void *restrict el1,
-		     void *restrict el2,
-		     void *restrict buf,
-		     const size_t width)
+static inline void swap_els(void *restrict el1,
+			    void *restrict el2,
+			    void *restrict buf,
+			    const size_t width)
 {
 	memcpy(buf, el1, width);
 	memcpy(el1, el2, width);
@@ -6,13 +6,19 @@
 
 #define RNG_MAX UINT32_MAX
 
-pcg32_random_t _RNG;
+extern pcg32_random_t _RNG;
 
 inline void init_rng(void)
 {
 	pcg32_srandom_r(&_RNG, time(NULL), (intptr_t)&_RNG);
 }
 
+/* reproducible sequence for a given 'seed' */
+inline void seed_rng(const uint64_t seed)
+{
+	pcg32_srandom_r(&_RNG, seed, 54u);
+}
+
 inline bool coin_flip(void)
 {
 	return (bool) (pcg32_random_r(&_RNG) & 1u);
@@ -63,11 +69,6 @@ inline double rand_in_dbl_range(const double lbound,
 	       + lbound;
 }
 
-static inline void swap_els(void *restrict el1,
-			    void *restrict el2,
-			    void *restrict buf,
-			    const size_t width);
-
 void shuffle_array(void *array,
 		   const size_t length,
 		   const size_t width);
@@ -0,0 +1,544 @@
+#include <vheap/vheap.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VHEAP_X86 1
+#include <immintrin.h>
+#endif /* if defined(__x86_64__) || defined(__i386__) */
+
+
+/* per-type scalar code: comparator for the backing 'struct BHeap', scalar
+ * child selection, shift up, shift down through 'select'
+ ******************************************************************************/
+#define VHEAP_DEFINE_TYPE(NAME, TYPE)					\
+static int compare_##NAME(const void *x,				\
+			  const void *y)				\
+{									\
+	return *((const TYPE *) x) < *((const TYPE *) y);		\
+}									\
+									\
+static size_t select_##NAME##_scalar(const void *const children,	\
+				     const size_t count)		\
+{									\
+	const TYPE *const keys = (const TYPE *) children;		\
+	size_t i_top = 0ul;						\
+									\
+	for (size_t i = 1ul; i < count; ++i)				\
+		if (keys[i] < keys[i_top])				\
+			i_top = i;					\
+									\
+	return i_top;							\
+}									\
+									\
+static void shift_up_##NAME(TYPE *const keys,				\
+			    const TYPE next,				\
+			    ptrdiff_t i_next,				\
+			    const unsigned int log_arity)		\
+{									\
+	ptrdiff_t i_parent;						\
+									\
+	while (i_next > 1l) {						\
+		i_parent = bheap_i_parent(i_next, log_arity);		\
+									\
+		if (!(next < keys[i_parent]))				\
+			break;						\
+									\
+		keys[i_next] = keys[i_parent];				\
+		i_next	     = i_parent;				\
+	}								\
+									\
+	keys[i_next] = next;						\
+}									\
+									\
+static void shift_down_##NAME(TYPE *const keys,			\
+			      const TYPE next,				\
+			      ptrdiff_t i_next,				\
+			      const ptrdiff_t i_base,			\
+			      const unsigned int log_arity,		\
+			      size_t (*select)(const void *const,	\
+					       const size_t))		\
+{									\
+	const ptrdiff_t arity = 1l << log_arity;			\
+	ptrdiff_t i_child, i_top;					\
+									\
+	while ((i_child = bheap_i_child(i_next, log_arity)) <= i_base) { \
+		/* full set of siblings -> one kernel call */		\
+		if ((i_child + arity - 1l) <= i_base)			\
+			i_top = i_child					\
+			      + select(&keys[i_child], arity);		\
+		else							\
+			i_top = i_child					\
+			      + select_##NAME##_scalar(&keys[i_child],	\
+						       i_base - i_child	\
+						       + 1l);		\
+									\
+		if (!(keys[i_top] < next))				\
+			break;						\
+									\
+		keys[i_next] = keys[i_top];				\
+		i_next	     = i_top;					\
+	}								\
+									\
+	keys[i_next] = next;						\
+}
+
+VHEAP_DEFINE_TYPE(u32,	  uint32_t)
+VHEAP_DEFINE_TYPE(u64,	  uint64_t)
+VHEAP_DEFINE_TYPE(float,  float)
+VHEAP_DEFINE_TYPE(double, double)
+
+#undef VHEAP_DEFINE_TYPE
+
+
+/* SIMD child selection: vertical min over the siblings, horizontal min
+ * broadcast to every lane, then the first lane equal to it
+ ******************************************************************************/
+#ifdef VHEAP_X86
+__attribute__((target("sse4.1")))
+static size_t select_u32_sse4(const void *const children,
+			      const size_t count)
+{
+	const __m128i *const keys = (const __m128i *) children;
+	const size_t count_vec	  = count / 4ul;
+	__m128i best;
+	int mask;
+
+	if (count_vec == 0ul)
+		return select_u32_scalar(children, count);
+
+	best = _mm_loadu_si128(&keys[0l]);
+	for (size_t i = 1ul; i < count_vec; ++i)
+		best = _mm_min_epu32(best, _mm_loadu_si128(&keys[i]));
+
+	best = _mm_min_epu32(best, _mm_shuffle_epi32(best, 0x4e));
+	best = _mm_min_epu32(best, _mm_shuffle_epi32(best, 0xb1));
+
+	for (size_t i = 0ul; ; ++i) {
+		mask = _mm_movemask_ps(_mm_castsi128_ps(
+			_mm_cmpeq_epi32(_mm_loadu_si128(&keys[i]), best)));
+
+		if (mask != 0)
+			return (i * 4ul) + __builtin_ctz(mask);
+	}
+}
+
+__attribute__((target("avx2")))
+static size_t select_u32_avx2(const void *const children,
+			      const size_t count)
+{
+	const __m256i *const keys = (const __m256i *) children;
+	const size_t count_vec	  = count / 8ul;
+	__m256i best;
+	__m128i half;
+	int mask;
+
+	if (count_vec == 0ul)
+		return select_u32_sse4(children, count);
+
+	best = _mm256_loadu_si256(&keys[0l]);
+	for (size_t i = 1ul; i < count_vec; ++i)
+		best = _mm256_min_epu32(best, _mm256_loadu_si256(&keys[i]));
+
+	half = _mm_min_epu32(_mm256_castsi256_si128(best),
+			     _mm256_extracti128_si256(best, 1));
+	half = _mm_min_epu32(half, _mm_shuffle_epi32(half, 0x4e));
+	half = _mm_min_epu32(half, _mm_shuffle_epi32(half, 0xb1));
+	best = _mm256_broadcastd_epi32(half);
+
+	for (size_t i = 0ul; ; ++i) {
+		mask = _mm256_movemask_ps(_mm256_castsi256_ps(
+			_mm256_cmpeq_epi32(_mm256_loadu_si256(&keys[i]),
+					   best)));
+
+		if (mask != 0)
+			return (i * 8ul) + __builtin_ctz(mask);
+	}
+}
+
+/* no unsigned 64-bit min: flip the sign bits and use the signed compare */
+__attribute__((target("sse4.2")))
+static inline __m128i min_u64_sse4(const __m128i x,
+				   const __m128i y)
+{
+	const __m128i sign = _mm_set1_epi64x((long long) (1ull << 63));
+
+	return _mm_blendv_epi8(x, y,
+			       _mm_cmpgt_epi64(_mm_xor_si128(x, sign),
+					       _mm_xor_si128(y, sign)));
+}
+
+__attribute__((target("sse4.2")))
+static size_t select_u64_sse4(const void *const children,
+			      const size_t count)
+{
+	const __m128i *const keys = (const __m128i *) children;
+	const size_t count_vec	  = count / 2ul;
+	__m128i best;
+	int mask;
+
+	if (count_vec == 0ul)
+		return select_u64_scalar(children, count);
+
+	best = _mm_loadu_si128(&keys[0l]);
+	for (size_t i = 1ul; i < count_vec; ++i)
+		best = min_u64_sse4(best, _mm_loadu_si128(&keys[i]));
+
+	best = min_u64_sse4(best, _mm_shuffle_epi32(best, 0x4e));
+
+	for (size_t i = 0ul; ; ++i) {
+		mask = _mm_movemask_pd(_mm_castsi128_pd(
+			_mm_cmpeq_epi64(_mm_loadu_si128(&keys[i]), best)));
+
+		if (mask != 0)
+			return (i * 2ul) + __builtin_ctz(mask);
+	}
+}
+
+__attribute__((target("avx2")))
+static inline __m256i min_u64_avx2(const __m256i x,
+				   const __m256i y)
+{
+	const __m256i sign = _mm256_set1_epi64x((long long) (1ull << 63));
+
+	return _mm256_blendv_epi8(x, y,
+				  _mm256_cmpgt_epi64(_mm256_xor_si256(x, sign),
+						     _mm256_xor_si256(y, sign)));
+}
+
+/* carries lane indices through the reduction, since a second pass to find
+ * the minimum costs more than the emulated 64-bit min itself */
+__attribute__((target("avx2")))
+static size_t select_u64_avx2(const void *const children,
+			      const size_t count)
+{
+	const __m256i *const keys = (const __m256i *) children;
+	const __m256i sign = _mm256_set1_epi64x((long long) (1ull << 63));
+	const __m256i step = _mm256_set1_epi64x(4ll);
+	__m256i best, best_index, next, next_index, swap;
+
+	if (count < 4ul)
+		return select_u64_sse4(children, count);
+
+	best	   = _mm256_xor_si256(_mm256_loadu_si256(&keys[0l]), sign);
+	best_index = _mm256_set_epi64x(3ll, 2ll, 1ll, 0ll);
+	next_index = best_index;
+
+	for (size_t i = 1ul; i < (count / 4ul); ++i) {
+		next	   = _mm256_xor_si256(_mm256_loadu_si256(&keys[i]),
+					      sign);
+		next_index = _mm256_add_epi64(next_index, step);
+		swap	   = _mm256_cmpgt_epi64(best, next);
+		best	   = _mm256_blendv_epi8(best, next, swap);
+		best_index = _mm256_blendv_epi8(best_index, next_index, swap);
+	}
+
+	next	   = _mm256_permute4x64_epi64(best,	  0x4e);
+	next_index = _mm256_permute4x64_epi64(best_index, 0x4e);
+	swap	   = _mm256_cmpgt_epi64(best, next);
+	best	   = _mm256_blendv_epi8(best, next, swap);
+	best_index = _mm256_blendv_epi8(best_index, next_index, swap);
+
+	next	   = _mm256_permute4x64_epi64(best,	  0xb1);
+	next_index = _mm256_permute4x64_epi64(best_index, 0xb1);
+	swap	   = _mm256_cmpgt_epi64(best, next);
+	best_index = _mm256_blendv_epi8(best_index, next_index, swap);
+
+	return (size_t) _mm256_extract_epi64(best_index, 0);
+}
+
+__attribute__((target("sse4.1")))
+static size_t select_float_sse4(const void *const children,
+				const size_t count)
+{
+	const float *const keys = (const float *) children;
+	__m128 best;
+	int mask;
+
+	if (count < 4ul)
+		return select_float_scalar(children, count);
+
+	best = _mm_loadu_ps(&keys[0l]);
+	for (size_t i = 4ul; i < count; i += 4ul)
+		best = _mm_min_ps(best, _mm_loadu_ps(&keys[i]));
+
+	best = _mm_min_ps(best, _mm_shuffle_ps(best, best, 0x4e));
+	best = _mm_min_ps(best, _mm_shuffle_ps(best, best, 0xb1));
+
+	for (size_t i = 0ul; ; i += 4ul) {
+		mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(&keys[i]),
+						    best));
+
+		if (mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+}
+
+__attribute__((target("avx2")))
+static size_t select_float_avx2(const void *const children,
+				const size_t count)
+{
+	const float *const keys = (const float *) children;
+	__m256 best;
+	int mask;
+
+	if (count < 8ul)
+		return select_float_sse4(children, count);
+
+	best = _mm256_loadu_ps(&keys[0l]);
+	for (size_t i = 8ul; i < count; i += 8ul)
+		best = _mm256_min_ps(best, _mm256_loadu_ps(&keys[i]));
+
+	best = _mm256_min_ps(best, _mm256_permute2f128_ps(best, best, 0x01));
+	best = _mm256_min_ps(best, _mm256_permute_ps(best, 0x4e));
+	best = _mm256_min_ps(best, _mm256_permute_ps(best, 0xb1));
+
+	for (size_t i = 0ul; ; i += 8ul) {
+		mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(&keys[i]),
+							best, _CMP_EQ_OQ));
+
+		if (mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+}
+
+__attribute__((target("sse4.1")))
+static size_t select_double_sse4(const void *const children,
+				 const size_t count)
+{
+	const double *const keys = (const double *) children;
+	__m128d best;
+	int mask;
+
+	if (count < 2ul)
+		return select_double_scalar(children, count);
+
+	best = _mm_loadu_pd(&keys[0l]);
+	for (size_t i = 2ul; i < count; i += 2ul)
+		best = _mm_min_pd(best, _mm_loadu_pd(&keys[i]));
+
+	best = _mm_min_pd(best, _mm_shuffle_pd(best, best, 0x1));
+
+	for (size_t i = 0ul; ; i += 2ul) {
+		mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(&keys[i]),
+						    best));
+
+		if (mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+}
+
+__attribute__((target("avx2")))
+static size_t select_double_avx2(const void *const children,
+				 const size_t count)
+{
+	const double *const keys = (const double *) children;
+	__m256d best;
+	int mask;
+
+	if (count < 4ul)
+		return select_double_sse4(children, count);
+
+	best = _mm256_loadu_pd(&keys[0l]);
+	for (size_t i = 4ul; i < count; i += 4ul)
+		best = _mm256_min_pd(best, _mm256_loadu_pd(&keys[i]));
+
+	best = _mm256_min_pd(best, _mm256_permute2f128_pd(best, best, 0x01));
+	best = _mm256_min_pd(best, _mm256_permute_pd(best, 0x5));
+
+	for (size_t i = 0ul; ; i += 4ul) {
+		mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(&keys[i]),
+							best, _CMP_EQ_OQ));
+
+		if (mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+}
+#endif /* ifdef VHEAP_X86 */
+
+
+/* dispatch
+ ******************************************************************************/
+struct VHeapKernels {
+	size_t width;
+	int (*compare)(const void *,
+		       const void *);
+	size_t (*select[3])(const void *const,
+			    const size_t);	/* indexed by 'enum VHeapISA' */
+};
+
+#ifdef VHEAP_X86
+#define VHEAP_KERNELS(NAME, TYPE)					\
+{									\
+	sizeof(TYPE), &compare_##NAME,					\
+	{ &select_##NAME##_scalar, &select_##NAME##_sse4,		\
+	  &select_##NAME##_avx2 }					\
+}
+#else
+#define VHEAP_KERNELS(NAME, TYPE)					\
+{									\
+	sizeof(TYPE), &compare_##NAME,					\
+	{ &select_##NAME##_scalar, NULL, NULL }				\
+}
+#endif /* ifdef VHEAP_X86 */
+
+static const struct VHeapKernels kernels[] = {
+	[VHEAP_KEY_U32]	   = VHEAP_KERNELS(u32,	   uint32_t),
+	[VHEAP_KEY_U64]	   = VHEAP_KERNELS(u64,	   uint64_t),
+	[VHEAP_KEY_FLOAT]  = VHEAP_KERNELS(float,  float),
+	[VHEAP_KEY_DOUBLE] = VHEAP_KERNELS(double, double)
+};
+
+#undef VHEAP_KERNELS
+
+size_t vheap_key_width(const enum VHeapKey key)
+{
+	return kernels[key].width;
+}
+
+enum VHeapISA vheap_best_isa(const enum VHeapKey key)
+{
+#ifdef VHEAP_X86
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2"))
+		return VHEAP_ISA_AVX2;
+
+	if ((key == VHEAP_KEY_U64) ? __builtin_cpu_supports("sse4.2")
+				   : __builtin_cpu_supports("sse4.1"))
+		return VHEAP_ISA_SSE4;
+#endif /* ifdef VHEAP_X86 */
+
+	return VHEAP_ISA_SCALAR;
+}
+
+
+/* initialize, destroy
+ ******************************************************************************/
+struct VHeap *init_sized_dary_vheap(const enum VHeapKey key,
+				    const size_t size,
+				    const size_t arity,
+				    const enum VHeapISA isa)
+{
+	struct VHeap *heap;
+
+	if (isa > vheap_best_isa(key))
+		EXIT_ON_FAILURE("kernel (%d) not supported by this CPU",
+				(int) isa);
+
+	HANDLE_MALLOC(heap, sizeof(struct VHeap));
+
+	heap->heap   = init_sized_dary_bheap(kernels[key].width, size, arity,
+					     kernels[key].compare);
+	heap->key    = key;
+	heap->isa    = isa;
+	heap->select = kernels[key].select[isa];
+
+	return heap;
+}
+
+extern inline struct VHeap *init_vheap(const enum VHeapKey key);
+
+extern inline void clear_vheap(struct VHeap *heap);
+
+extern inline void free_vheap(struct VHeap *heap);
+
+
+/* accessors
+ ******************************************************************************/
+extern inline size_t vheap_count(const struct VHeap *heap);
+
+extern inline const void *vheap_peek(const struct VHeap *heap);
+
+
+/* insertion
+ ******************************************************************************/
+void vheap_insert(struct VHeap *heap,
+		  const void *const key)
+{
+	struct BHeap *const nodes = heap->heap;
+
+	if (nodes->count == nodes->alloc)
+		realloc_bheap(nodes, nodes->alloc * 2ul);
+
+	++(nodes->count);
+
+	switch (heap->key) {
+	case VHEAP_KEY_U32:
+		shift_up_u32((uint32_t *) nodes->nodes,
+			     *((const uint32_t *) key),
+			     nodes->count, nodes->log_arity);
+		return;
+
+	case VHEAP_KEY_U64:
+		shift_up_u64((uint64_t *) nodes->nodes,
+			     *((const uint64_t *) key),
+			     nodes->count, nodes->log_arity);
+		return;
+
+	case VHEAP_KEY_FLOAT:
+		shift_up_float((float *) nodes->nodes,
+			       *((const float *) key),
+			       nodes->count, nodes->log_arity);
+		return;
+
+	default:
+		shift_up_double((double *) nodes->nodes,
+				*((const double *) key),
+				nodes->count, nodes->log_arity);
+	}
+}
+
+
+/* extraction
+ ******************************************************************************/
+bool vheap_extract(struct VHeap *heap,
+		   void *const out)
+{
+	struct BHeap *const nodes = heap->heap;
+	const ptrdiff_t i_base	  = nodes->count;
+
+	if (i_base == 0l)
+		return false;
+
+	/* root out, base node shifted down from the root */
+	memcpy(out, &nodes->nodes[nodes->width], nodes->width);
+
+	--(nodes->count);
+
+	if (i_base == 1l)
+		return true;
+
+	switch (heap->key) {
+	case VHEAP_KEY_U32: {
+		uint32_t *const keys = (uint32_t *) nodes->nodes;
+
+		shift_down_u32(keys, keys[i_base], 1l, i_base - 1l,
+			       nodes->log_arity, heap->select);
+		break;
+	}
+
+	case VHEAP_KEY_U64: {
+		uint64_t *const keys = (uint64_t *) nodes->nodes;
+
+		shift_down_u64(keys, keys[i_base], 1l, i_base - 1l,
+			       nodes->log_arity, heap->select);
+		break;
+	}
+
+	case VHEAP_KEY_FLOAT: {
+		float *const keys = (float *) nodes->nodes;
+
+		shift_down_float(keys, keys[i_base], 1l, i_base - 1l,
+				 nodes->log_arity, heap->select);
+		break;
+	}
+
+	default: {
+		double *const keys = (double *) nodes->nodes;
+
+		shift_down_double(keys, keys[i_base], 1l, i_base - 1l,
+				  nodes->log_arity, heap->select);
+	}
+	}
+
+	return true;
+}
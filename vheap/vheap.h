@@ -0,0 +1,108 @@
+#ifndef VHEAP_VHEAP_H_
+#define VHEAP_VHEAP_H_
+#include <stdbool.h>		/* bool */
+#include <stdint.h>		/* uint32_t, uint64_t */
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE */
+#include <bheap/bheap.h>	/* struct BHeap, d-ary index math */
+
+/*			- vheap.h -
+ * min-heap of primitive keys ('uint32_t', 'uint64_t', 'float', 'double') with
+ * vectorized child selection
+ *
+ * Keys are compared inline instead of through a 'compare' callback, and on a
+ * shift down a full set of siblings is reduced to its smallest member by one
+ * SIMD kernel (SSE4 or AVX2, chosen at run time with '__builtin_cpu_supports',
+ * scalar elsewhere).  The default arity fills one cache line with siblings:
+ * 16 for 4-byte keys, 8 for 8-byte keys.
+ *
+ * Storage is a 'struct BHeap' of 'width = sizeof(key)' (its 'compare' orders
+ * keys the same way, so 'print_bheap' and friends still apply).  Floating
+ * point keys must not be NaN.
+ */
+
+enum VHeapKey {
+	VHEAP_KEY_U32,
+	VHEAP_KEY_U64,
+	VHEAP_KEY_FLOAT,
+	VHEAP_KEY_DOUBLE
+};
+
+/* instruction set of the child selection kernel */
+enum VHeapISA {
+	VHEAP_ISA_SCALAR,
+	VHEAP_ISA_SSE4,		/* SSE4.1 (SSE4.2 for 'uint64_t' keys) */
+	VHEAP_ISA_AVX2
+};
+
+struct VHeap {
+	struct BHeap *heap;
+	enum VHeapKey key;
+	enum VHeapISA isa;
+	/* index of the smallest of 'count' keys at 'children', 'count' a
+	 * power of two no greater than the arity */
+	size_t (*select)(const void *const children,
+			 const size_t count);
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+/* width of 'key' */
+size_t vheap_key_width(const enum VHeapKey key);
+
+/* best kernel supported by the running CPU for 'key' */
+enum VHeapISA vheap_best_isa(const enum VHeapKey key);
+
+/* 'isa' must not exceed 'vheap_best_isa(key)' */
+struct VHeap *init_sized_dary_vheap(const enum VHeapKey key,
+				    const size_t size,
+				    const size_t arity,
+				    const enum VHeapISA isa);
+
+inline struct VHeap *init_vheap(const enum VHeapKey key)
+{
+	return init_sized_dary_vheap(key, BHEAP_DEFAULT_ALLOC,
+				     BHEAP_CACHE_LINE / vheap_key_width(key),
+				     vheap_best_isa(key));
+}
+
+inline void clear_vheap(struct VHeap *heap)
+{
+	clear_bheap(heap->heap);
+}
+
+inline void free_vheap(struct VHeap *heap)
+{
+	free_bheap(heap->heap);
+	free(heap);
+}
+
+
+/* accessors
+ ******************************************************************************/
+inline size_t vheap_count(const struct VHeap *heap)
+{
+	return heap->heap->count;
+}
+
+/* smallest key, NULL if empty */
+inline const void *vheap_peek(const struct VHeap *heap)
+{
+	return (heap->heap->count == 0ul)
+	     ? NULL
+	     : &heap->heap->nodes[heap->heap->width];
+}
+
+
+/* insertion
+ ******************************************************************************/
+void vheap_insert(struct VHeap *heap,
+		  const void *const key);
+
+
+/* extraction
+ ******************************************************************************/
+/* copies the smallest key into 'out' and returns true, or returns false if
+ * empty */
+bool vheap_extract(struct VHeap *heap,
+		   void *const out);
+#endif /* ifndef VHEAP_VHEAP_H_ */
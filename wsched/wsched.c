@@ -0,0 +1,355 @@
+#define _POSIX_C_SOURCE 200809L	/* posix_memalign, sysconf, sched_yield */
+#include <sched.h>		/* sched_yield */
+#include <unistd.h>		/* sysconf */
+#include <wsched/wsched.h>
+
+/* worker running on this thread, if any */
+static __thread struct WSchedWorker *current_worker;
+
+static int compare_task(const void *x,
+			const void *y)
+{
+	return ((const struct WSchedTask *) x)->priority
+	     > ((const struct WSchedTask *) y)->priority;
+}
+
+static inline struct WSchedWorker *own_worker(const struct WSched *sched)
+{
+	return ((current_worker != NULL) && (current_worker->sched == sched))
+	     ? current_worker
+	     : NULL;
+}
+
+
+/* per-worker heaps (caller holds 'worker->lock' when storing 'count')
+ ******************************************************************************/
+static inline void store_count(struct WSchedWorker *worker)
+{
+	__atomic_store_n(&worker->count, worker->tasks->count,
+			 __ATOMIC_RELAXED);
+}
+
+static inline size_t load_count(struct WSchedWorker *worker)
+{
+	return __atomic_load_n(&worker->count, __ATOMIC_RELAXED);
+}
+
+static void queue_task(struct WSched *sched,
+		       struct WSchedWorker *worker,
+		       const struct WSchedTask *const task)
+{
+	/* counted before it is published, so a thief taking it cannot drop
+	 * 'queued' below zero; pairs with the sleeper count then 'queued'
+	 * check in 'idle_wait': either it sees this task or this sees it
+	 * asleep */
+	__atomic_add_fetch(&sched->queued, 1ul, __ATOMIC_SEQ_CST);
+
+	pthread_mutex_lock(&worker->lock);
+	bheap_insert(worker->tasks, task);
+	store_count(worker);
+	pthread_mutex_unlock(&worker->lock);
+
+	if (__atomic_load_n(&sched->sleepers, __ATOMIC_SEQ_CST) > 0ul) {
+		pthread_mutex_lock(&sched->idle_lock);
+		pthread_cond_signal(&sched->wake);
+		pthread_mutex_unlock(&sched->idle_lock);
+	}
+}
+
+static bool pop_local(struct WSchedWorker *self,
+		      struct WSchedTask *const out)
+{
+	bool popped = false;
+
+	if (load_count(self) == 0ul)
+		return false;
+
+	pthread_mutex_lock(&self->lock);
+
+	if (self->tasks->count > 0ul) {
+		memcpy(out, bheap_extract(self->tasks),
+		       sizeof(struct WSchedTask));
+		store_count(self);
+		popped = true;
+	}
+
+	pthread_mutex_unlock(&self->lock);
+
+	return popped;
+}
+
+/* takes the best batch of a random victim, runs the first ('out') and keeps
+ * the rest */
+static bool steal(struct WSchedWorker *self,
+		  struct WSchedTask *const out)
+{
+	struct WSched *const sched = self->sched;
+	struct WSchedTask batch[WSCHED_STEAL_BATCH];
+	struct WSchedWorker *victim;
+	size_t i_victim, count, taken;
+
+	if (sched->count_workers < 2ul)
+		return false;
+
+	i_victim = pcg32_boundedrand_r(&self->rng,
+				       (uint32_t) (sched->count_workers - 1ul));
+	if (i_victim >= self->index)
+		++i_victim;
+
+	victim = &sched->workers[i_victim];
+
+	if ((load_count(victim) == 0ul)
+	    || (pthread_mutex_trylock(&victim->lock) != 0))
+		return false;
+
+	count = (victim->tasks->count + 1ul) / 2ul;
+	taken = bheap_extract_n(victim->tasks, &batch[0l],
+				(count < WSCHED_STEAL_BATCH)
+				? count
+				: WSCHED_STEAL_BATCH);
+	store_count(victim);
+	pthread_mutex_unlock(&victim->lock);
+
+	if (taken == 0ul)
+		return false;
+
+	*out = batch[0l];
+
+	if (taken > 1ul) {
+		pthread_mutex_lock(&self->lock);
+		bheap_insert_array(self->tasks, &batch[1l], taken - 1ul);
+		store_count(self);
+		pthread_mutex_unlock(&self->lock);
+	}
+
+	++(self->steals);
+	self->stolen += taken;
+
+	return true;
+}
+
+/* pops a local task or steals one, trying a few victims */
+static bool take_task(struct WSchedWorker *self,
+		      struct WSchedTask *const out)
+{
+	struct WSched *const sched = self->sched;
+	bool taken = pop_local(self, out);
+
+	for (size_t tries = 0ul;
+	     !taken && (tries < (2ul * sched->count_workers));
+	     ++tries)
+		taken = steal(self, out);
+
+	if (taken)
+		__atomic_sub_fetch(&sched->queued, 1ul, __ATOMIC_SEQ_CST);
+
+	return taken;
+}
+
+static void run_task(struct WSched *sched,
+		     struct WSchedWorker *self,
+		     const struct WSchedTask *const task)
+{
+	task->run(task->arg);
+
+	++(self->executed);
+
+	if ((task->group != NULL)
+	    && (__atomic_sub_fetch(&task->group->pending, 1ul,
+				   __ATOMIC_ACQ_REL) == 0ul)) {
+		pthread_mutex_lock(&sched->done_lock);
+		pthread_cond_broadcast(&sched->done);
+		pthread_mutex_unlock(&sched->done_lock);
+	}
+}
+
+
+/* workers
+ ******************************************************************************/
+static void idle_wait(struct WSched *sched)
+{
+	pthread_mutex_lock(&sched->idle_lock);
+
+	__atomic_add_fetch(&sched->sleepers, 1ul, __ATOMIC_SEQ_CST);
+
+	while (!__atomic_load_n(&sched->stop, __ATOMIC_SEQ_CST)
+	       && (__atomic_load_n(&sched->queued, __ATOMIC_SEQ_CST) == 0ul))
+		pthread_cond_wait(&sched->wake, &sched->idle_lock);
+
+	__atomic_sub_fetch(&sched->sleepers, 1ul, __ATOMIC_SEQ_CST);
+
+	pthread_mutex_unlock(&sched->idle_lock);
+}
+
+static void *work(void *arg)
+{
+	struct WSchedWorker *const self = (struct WSchedWorker *) arg;
+	struct WSched *const sched	= self->sched;
+	struct WSchedTask task;
+
+	current_worker = self;
+
+	while (1) {
+		if (take_task(self, &task)) {
+			run_task(sched, self, &task);
+			continue;
+		}
+
+		if (__atomic_load_n(&sched->stop, __ATOMIC_SEQ_CST))
+			break;
+
+		/* queued somewhere but contended: retry rather than sleep */
+		if (__atomic_load_n(&sched->queued, __ATOMIC_SEQ_CST) > 0ul)
+			sched_yield();
+		else
+			idle_wait(sched);
+	}
+
+	current_worker = NULL;
+
+	return NULL;
+}
+
+
+/* initialize, destroy
+ ******************************************************************************/
+struct WSched *init_wsched(size_t count_workers)
+{
+	struct WSched *sched;
+	struct WSchedWorker *worker;
+	void *workers;
+
+	if (count_workers == 0ul)
+		count_workers = (size_t) sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (count_workers == 0ul)
+		count_workers = 1ul;
+
+	HANDLE_MALLOC(sched, sizeof(struct WSched));
+
+	if (posix_memalign(&workers, BHEAP_CACHE_LINE,
+			   sizeof(struct WSchedWorker) * count_workers) != 0)
+		EXIT_ON_FAILURE("failed to allocate %lu workers",
+				count_workers);
+
+	sched->count_workers = count_workers;
+	sched->workers	     = (struct WSchedWorker *) workers;
+	sched->queued	     = 0ul;
+	sched->sleepers	     = 0ul;
+	sched->next_worker   = 0ul;
+	sched->stop	     = false;
+
+	if ((pthread_mutex_init(&sched->idle_lock, NULL) != 0)
+	    || (pthread_cond_init(&sched->wake, NULL) != 0)
+	    || (pthread_mutex_init(&sched->done_lock, NULL) != 0)
+	    || (pthread_cond_init(&sched->done, NULL) != 0))
+		EXIT_ON_FAILURE("failed to initialize scheduler locks");
+
+	for (size_t i = 0ul; i < count_workers; ++i) {
+		worker = &sched->workers[i];
+
+		if (pthread_mutex_init(&worker->lock, NULL) != 0)
+			EXIT_ON_FAILURE("failed to initialize lock %lu", i);
+
+		worker->tasks	 = init_bheap(sizeof(struct WSchedTask),
+					      &compare_task);
+		worker->count	 = 0ul;
+		worker->executed = 0ul;
+		worker->steals	 = 0ul;
+		worker->stolen	 = 0ul;
+		worker->index	 = i;
+		worker->sched	 = sched;
+
+		pcg32_srandom_r(&worker->rng, (uint64_t) (uintptr_t) sched, i);
+	}
+
+	/* every worker is set up before any may steal from it */
+	for (size_t i = 0ul; i < count_workers; ++i)
+		if (pthread_create(&sched->workers[i].thread, NULL, &work,
+				   &sched->workers[i]) != 0)
+			EXIT_ON_FAILURE("failed to create worker %lu", i);
+
+	return sched;
+}
+
+void free_wsched(struct WSched *sched)
+{
+	pthread_mutex_lock(&sched->idle_lock);
+	__atomic_store_n(&sched->stop, true, __ATOMIC_SEQ_CST);
+	pthread_cond_broadcast(&sched->wake);
+	pthread_mutex_unlock(&sched->idle_lock);
+
+	for (size_t i = 0ul; i < sched->count_workers; ++i)
+		pthread_join(sched->workers[i].thread, NULL);
+
+	for (size_t i = 0ul; i < sched->count_workers; ++i) {
+		pthread_mutex_destroy(&sched->workers[i].lock);
+		free_bheap(sched->workers[i].tasks);
+	}
+
+	pthread_cond_destroy(&sched->done);
+	pthread_mutex_destroy(&sched->done_lock);
+	pthread_cond_destroy(&sched->wake);
+	pthread_mutex_destroy(&sched->idle_lock);
+
+	free(sched->workers);
+	free(sched);
+}
+
+extern inline void init_wsched_group(struct WSchedGroup *group);
+
+
+/* submit, wait
+ ******************************************************************************/
+void wsched_submit(struct WSched *sched,
+		   struct WSchedGroup *group,
+		   const int64_t priority,
+		   WSchedRun run,
+		   void *arg)
+{
+	struct WSchedWorker *worker = own_worker(sched);
+	const struct WSchedTask task = {
+		.priority = priority,
+		.run	  = run,
+		.arg	  = arg,
+		.group	  = group
+	};
+
+	if (group != NULL)
+		__atomic_add_fetch(&group->pending, 1ul, __ATOMIC_ACQ_REL);
+
+	/* from outside the pool: deal to workers in turn */
+	if (worker == NULL)
+		worker = &sched->workers[__atomic_fetch_add(&sched->next_worker,
+							    1ul,
+							    __ATOMIC_RELAXED)
+					 % sched->count_workers];
+
+	queue_task(sched, worker, &task);
+}
+
+void wsched_wait(struct WSched *sched,
+		 struct WSchedGroup *group)
+{
+	struct WSchedWorker *const self = own_worker(sched);
+	struct WSchedTask task;
+
+	/* on a worker: help instead of blocking it */
+	if (self != NULL) {
+		while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) > 0ul) {
+			if (take_task(self, &task))
+				run_task(sched, self, &task);
+			else
+				sched_yield();
+		}
+
+		return;
+	}
+
+	pthread_mutex_lock(&sched->done_lock);
+
+	while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) > 0ul)
+		pthread_cond_wait(&sched->done, &sched->done_lock);
+
+	pthread_mutex_unlock(&sched->done_lock);
+}
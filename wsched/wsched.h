@@ -0,0 +1,98 @@
+#ifndef WSCHED_WSCHED_H_
+#define WSCHED_WSCHED_H_
+#include <stdbool.h>		/* bool */
+#include <stdint.h>		/* int64_t */
+#include <pthread.h>		/* pthread_t, pthread_mutex_t, pthread_cond_t */
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE */
+#include <utils/pcg_basic.h>	/* pcg32_random_t */
+#include <bheap/bheap.h>	/* struct BHeap, BHEAP_CACHE_LINE */
+
+/*			- wsched.h -
+ * work-stealing priority task scheduler over per-worker 'struct BHeap's
+ *
+ * Each worker thread owns a heap of tasks ordered by priority (highest
+ * first).  Tasks submitted from a worker go to its own heap, and it pops
+ * from there, so the heap's lock is only contended by thieves.  An idle
+ * worker picks a victim with its own pcg32 generator and steals its best
+ * tasks in one batch ('bheap_extract_n'): up to half of them, at most
+ * WSCHED_STEAL_BATCH.  It runs the best one and keeps the rest.  Tasks
+ * submitted from other threads are dealt to workers in turn.  Workers with
+ * nothing to run or steal sleep until new tasks are queued.
+ *
+ * Completion is tracked per 'struct WSchedGroup': 'wsched_wait' returns once
+ * every task submitted to the group has run.  On a worker (fork/join inside a
+ * task), it runs other tasks while waiting instead of blocking.
+ */
+
+/* most tasks taken from a victim in one steal */
+#ifndef WSCHED_STEAL_BATCH
+#define WSCHED_STEAL_BATCH 16ul
+#endif /* ifndef WSCHED_STEAL_BATCH */
+
+typedef void (*WSchedRun)(void *arg);
+
+struct WSchedGroup {
+	size_t pending;		/* submitted tasks not yet finished */
+};
+
+struct WSchedTask {
+	int64_t priority;	/* higher runs first */
+	WSchedRun run;
+	void *arg;
+	struct WSchedGroup *group;
+};
+
+struct WSchedWorker {
+	pthread_mutex_t lock;	/* guards 'tasks' */
+	struct BHeap *tasks;
+	size_t count;		/* 'tasks->count', readable without 'lock' */
+	pcg32_random_t rng;	/* victim selection */
+	size_t executed;	/* tasks run */
+	size_t steals;		/* successful steals */
+	size_t stolen;		/* tasks taken in them */
+	size_t index;
+	struct WSched *sched;
+	pthread_t thread;
+} __attribute__((aligned(BHEAP_CACHE_LINE)));
+
+struct WSched {
+	size_t count_workers;
+	struct WSchedWorker *workers;
+	size_t queued;		/* tasks waiting in heaps */
+	size_t sleepers;	/* workers waiting on 'wake' */
+	size_t next_worker;	/* turn for external submissions */
+	bool stop;
+	pthread_mutex_t idle_lock;
+	pthread_cond_t wake;	/* tasks queued or 'stop' */
+	pthread_mutex_t done_lock;
+	pthread_cond_t done;	/* some group's 'pending' reached 0 */
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+/* starts 'count_workers' worker threads (0 for one per online processor) */
+struct WSched *init_wsched(const size_t count_workers);
+
+/* stops and joins the workers once every queued task has run, tasks those
+ * submit included */
+void free_wsched(struct WSched *sched);
+
+inline void init_wsched_group(struct WSchedGroup *group)
+{
+	group->pending = 0ul;
+}
+
+
+/* submit, wait
+ ******************************************************************************/
+/* queues 'run(arg)' at 'priority', counted against 'group' (may be NULL) */
+void wsched_submit(struct WSched *sched,
+		   struct WSchedGroup *group,
+		   const int64_t priority,
+		   WSchedRun run,
+		   void *arg);
+
+/* returns once every task submitted to 'group' has run */
+void wsched_wait(struct WSched *sched,
+		 struct WSchedGroup *group);
+#endif /* ifndef WSCHED_WSCHED_H_ */
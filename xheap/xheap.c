@@ -0,0 +1,319 @@
+#define _POSIX_C_SOURCE 200809L	/* mkstemp, fdopen */
+#include <stdbool.h>		/* bool */
+#include <stdlib.h>		/* mkstemp */
+#include <unistd.h>		/* unlink, close */
+#include <xheap/xheap.h>
+
+/* runs
+ ******************************************************************************/
+static FILE *open_run_file(const char *const dir)
+{
+	FILE *file;
+
+	if (dir == NULL) {
+		file = tmpfile();
+
+	} else {
+		const size_t length = strlen(dir) + sizeof("/xheap-XXXXXX");
+		char path[length];
+		int fd;
+
+		snprintf(&path[0l], length, "%s/xheap-XXXXXX", dir);
+
+		fd = mkstemp(&path[0l]);
+		if (fd < 0)
+			EXIT_ON_FAILURE("failed to create run file in '%s'", dir);
+
+		/* reclaimed on close, even if the process dies */
+		unlink(&path[0l]);
+
+		file = fdopen(fd, "w+b");
+		if (file == NULL)
+			close(fd);
+	}
+
+	if (file == NULL)
+		EXIT_ON_FAILURE("failed to open run file");
+
+	return file;
+}
+
+static void fill_run_buffer(struct XHeap *heap,
+			    struct XHeapRun *run)
+{
+	const size_t count = (run->count_file < heap->run_nodes)
+			   ? run->count_file
+			   : heap->run_nodes;
+
+	if (fread(run->buffer, heap->width, count, run->file) != count)
+		EXIT_ON_FAILURE("failed to read %lu nodes from run", count);
+
+	run->count_file  -= count;
+	run->count_buffer = count;
+	run->i_buffer	  = 0ul;
+}
+
+static void close_run(struct XHeap *heap,
+		      struct XHeapRun *run)
+{
+	fclose(run->file);
+	free(run->buffer);
+	run->file = NULL;
+	--(heap->count_runs);
+}
+
+/* enters the next node of 'runs[i_run]' into the tournament, returning false
+ * (and closing the run) if it is exhausted */
+static bool next_head(struct XHeap *heap,
+		      const size_t i_run,
+		      char *const head)
+{
+	struct XHeapRun *const run = &heap->runs[i_run];
+
+	if (run->i_buffer == run->count_buffer) {
+		if (run->count_file == 0ul) {
+			close_run(heap, run);
+			return false;
+		}
+
+		fill_run_buffer(heap, run);
+	}
+
+	memcpy(head, &run->buffer[run->i_buffer * heap->width], heap->width);
+	memcpy(&head[heap->head_width - sizeof(size_t)], &i_run,
+	       sizeof(size_t));
+
+	++(run->i_buffer);
+
+	return true;
+}
+
+/* opens an empty run in a free slot, returning its index */
+static size_t open_run(struct XHeap *heap)
+{
+	size_t i_run = 0ul;
+
+	while (heap->runs[i_run].file != NULL)
+		++i_run;
+
+	heap->runs[i_run].file	     = open_run_file(heap->dir);
+	heap->runs[i_run].count_file = 0ul;
+
+	HANDLE_MALLOC(heap->runs[i_run].buffer, heap->width * heap->run_nodes);
+
+	++(heap->count_runs);
+
+	return i_run;
+}
+
+/* rewinds a fully written run and enters its first node */
+static void start_run(struct XHeap *heap,
+		      const size_t i_run,
+		      const size_t count)
+{
+	struct XHeapRun *const run = &heap->runs[i_run];
+	char head[heap->head_width];
+
+	if ((fflush(run->file) != 0) || (fseek(run->file, 0l, SEEK_SET) != 0))
+		EXIT_ON_FAILURE("failed to rewind run");
+
+	run->count_file   = count;
+	run->count_buffer = 0ul;
+	run->i_buffer	  = 0ul;
+
+	if (next_head(heap, i_run, &head[0l]))
+		bheap_insert(heap->tournament, &head[0l]);
+}
+
+/* copies the tournament root into 'out' and replaces it with the next node
+ * of its run */
+static void take_head(struct XHeap *heap,
+		      void *const out)
+{
+	struct BHeap *const tournament = heap->tournament;
+	const char *const root = &tournament->nodes[heap->head_width];
+	char head[heap->head_width];
+	size_t i_run;
+
+	memcpy(out, root, heap->width);
+	memcpy(&i_run, &root[heap->head_width - sizeof(size_t)],
+	       sizeof(size_t));
+
+	if (next_head(heap, i_run, &head[0l]))
+		do_bheap_shift(tournament->nodes, &head[0l], heap->head_width,
+			       1l, tournament->count, tournament->compare);
+	else
+		(void) bheap_extract(tournament);
+}
+
+/* merges every run into one */
+static void compact_runs(struct XHeap *heap)
+{
+	const size_t width = heap->width;
+	size_t count	   = 0ul;
+	size_t count_out   = 0ul;
+	char *out;
+
+	HANDLE_MALLOC(out, width * heap->run_nodes);
+
+	/* the drained runs free their slots before the merged one is opened,
+	 * so write through a spare slot */
+	heap->runs[heap->max_runs].file = open_run_file(heap->dir);
+	HANDLE_MALLOC(heap->runs[heap->max_runs].buffer,
+		      width * heap->run_nodes);
+
+	while (heap->tournament->count > 0ul) {
+		take_head(heap, &out[count_out * width]);
+		++count_out;
+
+		if (count_out == heap->run_nodes) {
+			if (fwrite(out, width, count_out,
+				   heap->runs[heap->max_runs].file)
+			    != count_out)
+				EXIT_ON_FAILURE("failed to write run");
+
+			count	 += count_out;
+			count_out = 0ul;
+		}
+	}
+
+	if (fwrite(out, width, count_out, heap->runs[heap->max_runs].file)
+	    != count_out)
+		EXIT_ON_FAILURE("failed to write run");
+
+	count += count_out;
+
+	free(out);
+
+	heap->runs[0l]			= heap->runs[heap->max_runs];
+	heap->runs[heap->max_runs].file = NULL;
+	heap->count_runs		= 1ul;
+
+	start_run(heap, 0ul, count);
+}
+
+/* heapsorts the full insertion heap into a new run */
+static void spill(struct XHeap *heap)
+{
+	struct BHeap *const insertion = heap->insertion;
+	const size_t count	      = insertion->count;
+	size_t i_run;
+
+	if (heap->count_runs == heap->max_runs)
+		compact_runs(heap);
+
+	do_bheap_sort(insertion->nodes, count, heap->width,
+		      insertion->log_arity, insertion->shift_mode,
+		      insertion->compare);
+
+	i_run = open_run(heap);
+
+	if (fwrite(&insertion->nodes[heap->width], heap->width, count,
+		   heap->runs[i_run].file) != count)
+		EXIT_ON_FAILURE("failed to write run of %lu nodes", count);
+
+	start_run(heap, i_run, count);
+
+	heap->count_spilled += count;
+
+	clear_bheap(insertion);
+}
+
+
+/* initialize, destroy
+ ******************************************************************************/
+struct XHeap *init_xheap(const size_t width,
+			 const size_t budget,
+			 const char *const dir,
+			 int (*compare)(const void *,
+					const void *))
+{
+	struct XHeap *heap;
+	const size_t capacity = (budget / 2ul) / width;
+
+	if (capacity < 2ul)
+		EXIT_ON_FAILURE("budget (%lu bytes) too small for nodes of %lu "
+				"bytes", budget, width);
+
+	HANDLE_MALLOC(heap, sizeof(struct XHeap));
+	HANDLE_MALLOC(heap->out, width);
+
+	heap->count	    = 0ul;
+	heap->width	    = width;
+	heap->run_nodes	    = (XHEAP_RUN_BUFFER > width)
+			    ? (XHEAP_RUN_BUFFER / width)
+			    : 1ul;
+	heap->max_runs	    = (budget / 2ul) / (heap->run_nodes * width);
+	heap->count_runs    = 0ul;
+	heap->count_spilled = 0ul;
+	heap->head_width    = ((width + sizeof(size_t) - 1ul)
+			       & ~(sizeof(size_t) - 1ul))
+			    + sizeof(size_t);
+	heap->dir	    = dir;
+	heap->compare	    = compare;
+
+	if (heap->max_runs < 2ul)
+		heap->max_runs = 2ul;
+
+	/* head node leads each tournament node, so 'compare' applies as is */
+	heap->insertion  = init_sized_bheap(width, capacity, compare);
+	heap->tournament = init_sized_dary_bheap(heap->head_width,
+						 heap->max_runs, 2ul, compare);
+
+	/* one spare slot for compaction */
+	HANDLE_CALLOC(heap->runs, heap->max_runs + 1ul,
+		      sizeof(struct XHeapRun));
+
+	return heap;
+}
+
+void free_xheap(struct XHeap *heap)
+{
+	for (size_t i = 0ul; i < heap->max_runs; ++i)
+		if (heap->runs[i].file != NULL)
+			close_run(heap, &heap->runs[i]);
+
+	free_bheap(heap->insertion);
+	free_bheap(heap->tournament);
+	free(heap->runs);
+	free(heap->out);
+	free(heap);
+}
+
+
+/* insertion
+ ******************************************************************************/
+void xheap_insert(struct XHeap *heap,
+		  const void *const next)
+{
+	if (heap->insertion->count == heap->insertion->alloc)
+		spill(heap);
+
+	bheap_insert(heap->insertion, next);
+
+	++(heap->count);
+}
+
+
+/* extraction
+ ******************************************************************************/
+void *xheap_extract(struct XHeap *heap)
+{
+	struct BHeap *const insertion  = heap->insertion;
+	struct BHeap *const tournament = heap->tournament;
+
+	if (heap->count == 0ul)
+		return NULL;
+
+	--(heap->count);
+
+	if ((tournament->count == 0ul)
+	    || ((insertion->count > 0ul)
+		&& heap->compare(&insertion->nodes[insertion->width],
+				 &tournament->nodes[tournament->width])))
+		return bheap_extract(insertion);
+
+	take_head(heap, heap->out);
+
+	return heap->out;
+}
@@ -0,0 +1,78 @@
+#ifndef XHEAP_XHEAP_H_
+#define XHEAP_XHEAP_H_
+#include <stdio.h>		/* FILE */
+#include <utils/utils.h>	/* HANDLE_MALLOC, EXIT_ON_FAILURE */
+#include <bheap/bheap.h>	/* struct BHeap */
+
+/*			- xheap.h -
+ * external-memory (sequence) heap for queues larger than RAM
+ *
+ * Insertions go to an in-memory 'struct BHeap'.  When it fills its share of
+ * the memory budget it is heapsorted and written out as one sequential run to
+ * an unlinked temporary file.  Runs are read back through fixed-size buffers
+ * and merged by a tournament 'struct BHeap' of run heads; extraction takes
+ * the better of the insertion heap root and the tournament root.  When the
+ * buffers for more runs would overflow the budget, all runs are first merged
+ * into one.
+ *
+ * Of 'budget' bytes, half holds the insertion heap and half the run buffers
+ * (XHEAP_RUN_BUFFER bytes each, at least two).
+ *
+ * 'compare(x, y)' returns nonzero if node 'x' belongs above node 'y'
+ */
+
+/* bytes of read buffer per run */
+#ifndef XHEAP_RUN_BUFFER
+#define XHEAP_RUN_BUFFER (1ul << 16)
+#endif /* ifndef XHEAP_RUN_BUFFER */
+
+struct XHeapRun {
+	FILE *file;
+	size_t count_file;	/* nodes still in 'file' */
+	size_t count_buffer;	/* nodes loaded in 'buffer' */
+	size_t i_buffer;	/* next node in 'buffer' */
+	char *buffer;
+};
+
+struct XHeap {
+	size_t count;		/* count of nodes, in memory and on disk */
+	size_t width;		/* byte size per node */
+	size_t run_nodes;	/* nodes per run buffer */
+	size_t max_runs;	/* runs whose buffers fit the budget */
+	size_t count_runs;
+	size_t count_spilled;	/* nodes written to runs over all time */
+	struct BHeap *insertion;
+	struct BHeap *tournament;	/* (head node, run index) per run */
+	size_t head_width;	/* tournament node width */
+	struct XHeapRun *runs;
+	char *out;		/* last extracted node */
+	const char *dir;	/* NULL: tmpfile() */
+	int (*compare)(const void *,
+		       const void *);
+};
+
+/* initialize, destroy
+ ******************************************************************************/
+/* spills to unlinked files in 'dir' ('NULL' for the system temporary
+ * directory) once 'budget' bytes are exceeded */
+struct XHeap *init_xheap(const size_t width,
+			 const size_t budget,
+			 const char *const dir,
+			 int (*compare)(const void *,
+					const void *));
+
+void free_xheap(struct XHeap *heap);
+
+
+/* insertion
+ ******************************************************************************/
+void xheap_insert(struct XHeap *heap,
+		  const void *const next);
+
+
+/* extraction
+ ******************************************************************************/
+/* returns a pointer to the extracted node, valid until the next call that
+ * modifies 'heap', or NULL if empty */
+void *xheap_extract(struct XHeap *heap);
+#endif /* ifndef XHEAP_XHEAP_H_ */